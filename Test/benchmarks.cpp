@@ -0,0 +1,468 @@
+/// Benchmarks of the renderer, registered with CTest. Figures are drawn offscreen on an export context of
+/// ImGuiContextManager, as imGuiPlotMex("export", ...) draws them, so no window is shown. That context
+/// still comes from a hidden GLFW window, so the render benchmarks need a display: on a machine without
+/// one, run them under a virtual X server (xvfb-run ctest), or they are skipped. The ingest benchmark
+/// needs no OpenGL and always runs.
+/// Usage: imGuiPlotBenchmarks render-10m|frame-4x4|steady-allocations|ingest-1gb
+
+#include "MatlabImGuiPlot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace
+{
+/// Allocations are counted while processPlots runs, through operator new and through ImGui's allocator
+std::atomic<bool>   gCounting         = false;
+std::atomic<size_t> gHeapAllocations  = 0;
+std::atomic<size_t> gImGuiAllocations = 0;
+
+/// Allocator of ImGuiContextManager, which the counting one forwards to
+ImGuiMemAllocFunc gImGuiAllocate      = NULL;
+ImGuiMemFreeFunc  gImGuiDeallocate    = NULL;
+void*             gImGuiAllocatorData = NULL;
+
+void* countImGuiAllocation(size_t size, void* userData)
+{
+    if (gCounting)
+    {
+        gImGuiAllocations++;
+    }
+    return gImGuiAllocate(size, userData);
+}
+
+void forwardImGuiDeallocation(void* ptr, void* userData)
+{
+    gImGuiDeallocate(ptr, userData);
+}
+} // namespace
+
+void* operator new(size_t size)
+{
+    if (gCounting)
+    {
+        gHeapAllocations++;
+    }
+    if (void* ptr = std::malloc(size > 0 ? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+/// Exit code CTest reports as skipped, see SKIP_RETURN_CODE in CMakeLists.txt
+constexpr int SKIPPED = 77;
+
+constexpr int WIDTH         = 1280;
+constexpr int HEIGHT        = 720;
+constexpr int WARMUP_FRAMES = 10;  // font atlas, device objects and ImGui/ImPlot pools are built here
+constexpr int FRAMES        = 100; // frames each time is averaged over
+
+using Clock_t = std::chrono::steady_clock;
+
+double getSeconds(Clock_t::time_point start)
+{
+    return std::chrono::duration<double>(Clock_t::now() - start).count();
+}
+
+/// Mean times of one benchmark's frames
+struct FrameTimes_t
+{
+    double cpu              = 0.0; // NewFrame to Render: processPlots and ImGui's draw lists
+    double total            = 0.0; // including the OpenGL draw, up to glFinish
+    int    vertices         = 0;   // of the last frame
+    size_t heapAllocations  = 0;   // made by processPlots over all frames, through operator new
+    size_t imGuiAllocations = 0;   // and through ImGui's allocator
+};
+
+/// <summary>
+/// Subplot of numSeries line series sharing one x column of numSamples samples, prepared as a MEX call
+/// prepares it
+/// </summary>
+ImPlot::PlotData_t makeSubplot(size_t numSamples, size_t numSeries)
+{
+    std::vector<double> x(numSamples);
+    std::iota(x.begin(), x.end(), 0.0);
+    std::vector<double> y(numSamples * numSeries);
+    for (size_t series = 0; series < numSeries; series++)
+    {
+        for (size_t sample = 0; sample < numSamples; sample++)
+        {
+            const double t                  = static_cast<double>(sample);
+            y[series * numSamples + sample] = std::sin(t * 1e-3 + series) + 0.1 * std::sin(t * 0.7);
+        }
+    }
+
+    ImPlot::PlotData_t data = {};
+    data.data1.assign(std::move(x), numSamples, 1);
+    data.data1.broadcast(numSeries);
+
+    ImPlot::ColumnMatrix_t<double> columns = {};
+    columns.assign(std::move(y), numSamples, numSeries);
+    data.data2 = ImPlot::SeriesMatrix_t(std::move(columns));
+
+    for (size_t series = 0; series < numSeries; series++)
+    {
+        data.legends.push_back("series " + std::to_string(series + 1));
+    }
+    data.plotInfo.data1Available   = true;
+    data.plotInfo.data2Available   = true;
+    data.plotInfo.onlyStructures   = true;
+    data.plotInfo.legendsAvailable = true;
+
+    MatlabImGuiPlot::prepare(data);
+    return data;
+}
+
+/// <summary>
+/// Figure of rows x columns subplots
+/// </summary>
+ImPlot::MatlabInput_t makeFigure(size_t rows, size_t columns, size_t numSamples, size_t numSeries)
+{
+    ImPlot::MatlabInput_t figure = {};
+    figure.figureConfig          = "Benchmark";
+    figure.windowTitle           = "Benchmark##1";
+    figure.handle                = 1;
+    figure.subModuleDimensions   = {static_cast<double>(rows), static_cast<double>(columns)};
+    for (size_t subplot = 0; subplot < rows * columns; subplot++)
+    {
+        figure.plotData.push_back(makeSubplot(numSamples, numSeries));
+    }
+    return figure;
+}
+
+/// <summary>
+/// Make an export context current with a WIDTH x HEIGHT framebuffer bound
+/// </summary>
+/// <returns>NULL if there is no display or the framebuffer cannot be made</returns>
+ImPlot::OffscreenContext_t* bindContext()
+{
+    const auto contexts = ImGuiContextManager::getInstance().getOffscreenContexts(1);
+    if (contexts.empty())
+    {
+        return NULL;
+    }
+
+    auto* context = contexts[0];
+    glfwMakeContextCurrent(context->window);
+    ImGui::SetCurrentContext(context->imGuiContext);
+    ImPlot::SetCurrentContext(context->imPlotContext);
+    if (!context->target.bind(WIDTH, HEIGHT))
+    {
+        return NULL;
+    }
+
+    ImGuiIO& io                = ImGui::GetIO();
+    io.DisplaySize             = ImVec2(static_cast<float>(WIDTH), static_cast<float>(HEIGHT));
+    io.DisplayFramebufferScale = ImVec2(1.0f, 1.0f);
+    io.DeltaTime               = 1.0f / 60.0f;
+
+    // count ImGui's and ImPlot's allocations too, they share one allocator
+    if (gImGuiAllocate == NULL)
+    {
+        ImGui::GetAllocatorFunctions(&gImGuiAllocate, &gImGuiDeallocate, &gImGuiAllocatorData);
+        ImGui::SetAllocatorFunctions(countImGuiAllocation, forwardImGuiDeallocation, gImGuiAllocatorData);
+    }
+    return context;
+}
+
+/// Work timed with each frame, before it is built
+typedef std::function<void()> FrameWork_t;
+
+/// <summary>
+/// Draw one frame of the figures into the bound framebuffer, as MatlabImGuiPlot::renderOffscreen does
+/// </summary>
+void drawFrame(MatlabImGuiPlot&                          plot,
+               const std::vector<ImPlot::MatlabInput_t>& figures,
+               const FrameWork_t&                        work,
+               FrameTimes_t&                             times)
+{
+    const auto start = Clock_t::now();
+    if (work)
+    {
+        work();
+    }
+    glClearColor(0.45f, 0.55f, 0.60f, 1.00f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    ImGui_ImplOpenGL3_NewFrame();
+    ImGui::NewFrame();
+    const size_t heapAllocations  = gHeapAllocations;
+    const size_t imGuiAllocations = gImGuiAllocations;
+    gCounting                     = true;
+    plot.processPlots(figures, true);
+    gCounting = false;
+    times.heapAllocations += gHeapAllocations - heapAllocations;
+    times.imGuiAllocations += gImGuiAllocations - imGuiAllocations;
+    ImGui::Render();
+    times.cpu += getSeconds(start);
+
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    glFinish();
+    times.total += getSeconds(start);
+    times.vertices = ImGui::GetDrawData()->TotalVtxCount;
+}
+
+/// <summary>
+/// Mean times of FRAMES frames after WARMUP_FRAMES
+/// </summary>
+FrameTimes_t measureFrames(MatlabImGuiPlot&                          plot,
+                           const std::vector<ImPlot::MatlabInput_t>& figures,
+                           const FrameWork_t&                        work = {})
+{
+    FrameTimes_t times = {};
+    for (int frame = 0; frame < WARMUP_FRAMES; frame++)
+    {
+        drawFrame(plot, figures, work, times);
+    }
+
+    times = {};
+    for (int frame = 0; frame < FRAMES; frame++)
+    {
+        drawFrame(plot, figures, work, times);
+    }
+    times.cpu /= FRAMES;
+    times.total /= FRAMES;
+    return times;
+}
+
+/// <summary>
+/// One 10M-sample line, drawn from the stored buffers through the min/max pyramid. A line through every
+/// sample would take 40M vertices; the pyramid keeps it to a few per pixel column.
+/// </summary>
+int renderLongSeries()
+{
+    constexpr size_t NUM_SAMPLES  = 10000000;
+    constexpr int    MAX_VERTICES = 200000;
+
+    auto* context = bindContext();
+    if (!context)
+    {
+        std::printf("render-10m: skipped, no OpenGL context (needs a display or Xvfb)\n");
+        return SKIPPED;
+    }
+
+    const auto                         ingestStart = Clock_t::now();
+    std::vector<ImPlot::MatlabInput_t> figures     = {makeFigure(1, 1, NUM_SAMPLES, 1)};
+    const double                       ingest      = getSeconds(ingestStart);
+
+    MatlabImGuiPlot plot;
+    const auto      times = measureFrames(plot, figures);
+    context->target.unbind();
+
+    std::printf("render-10m: %zu samples, prepared in %.1f ms, frame %.3f ms cpu, %.3f ms total, %d vertices\n",
+                NUM_SAMPLES,
+                ingest * 1e3,
+                times.cpu * 1e3,
+                times.total * 1e3,
+                times.vertices);
+    if (times.vertices > MAX_VERTICES)
+    {
+        std::printf("render-10m: FAILED, more than %d vertices\n", MAX_VERTICES);
+        return 1;
+    }
+    return 0;
+}
+
+/// <summary>
+/// Per-frame CPU time of a 4x4 figure with 20 series per subplot, drawn from the draw commands compiled
+/// at ingest, against frames that also run prepare on every subplot, i.e. errorCheck and compiling the
+/// draw commands. That second number only prices the validation moved out of the frame; it is not the
+/// old frame loop, which also sorted, deduplicated and copied the samples every frame.
+/// </summary>
+int renderSubplotGrid()
+{
+    constexpr size_t ROWS        = 4;
+    constexpr size_t COLUMNS     = 4;
+    constexpr size_t NUM_SERIES  = 20;
+    constexpr size_t NUM_SAMPLES = 1000;
+
+    auto* context = bindContext();
+    if (!context)
+    {
+        std::printf("frame-4x4: skipped, no OpenGL context (needs a display or Xvfb)\n");
+        return SKIPPED;
+    }
+
+    std::vector<ImPlot::MatlabInput_t> figures = {makeFigure(ROWS, COLUMNS, NUM_SAMPLES, NUM_SERIES)};
+
+    // errorCheck and draw commands only; the data1/data2 caches are kept, as previous is the data itself
+    auto revalidate = [&figures]()
+    {
+        for (auto& data : figures[0].plotData)
+        {
+            MatlabImGuiPlot::prepare(data, &data);
+        }
+    };
+
+    MatlabImGuiPlot plot;
+    const auto      prepared  = measureFrames(plot, figures);
+    const auto      validated = measureFrames(plot, figures, revalidate);
+    context->target.unbind();
+
+    std::printf("frame-4x4: %zux%zu subplots of %zu series, frame %.3f ms cpu (%.3f ms total) from draw commands, "
+                "%.3f ms cpu (%.3f ms total) with errorCheck and command compilation every frame\n",
+                ROWS,
+                COLUMNS,
+                NUM_SERIES,
+                prepared.cpu * 1e3,
+                prepared.total * 1e3,
+                validated.cpu * 1e3,
+                validated.total * 1e3);
+    return 0;
+}
+
+/// <summary>
+/// Frames of a figure that does not change, once warm, must not allocate in processPlots: the sample
+/// buffers, draw commands and pyramids are read in place and ImGui/ImPlot reuse their buffers
+/// </summary>
+int renderSteadyFigure()
+{
+    constexpr size_t ROWS        = 2;
+    constexpr size_t COLUMNS     = 2;
+    constexpr size_t NUM_SERIES  = 5;
+    constexpr size_t NUM_SAMPLES = 100000;
+
+    auto* context = bindContext();
+    if (!context)
+    {
+        std::printf("steady-allocations: skipped, no OpenGL context (needs a display or Xvfb)\n");
+        return SKIPPED;
+    }
+
+    std::vector<ImPlot::MatlabInput_t> figures = {makeFigure(ROWS, COLUMNS, NUM_SAMPLES, NUM_SERIES)};
+
+    MatlabImGuiPlot plot;
+    const auto      times = measureFrames(plot, figures);
+    context->target.unbind();
+
+    std::printf("steady-allocations: %d frames, %zu heap and %zu ImGui allocations in processPlots\n",
+                FRAMES,
+                times.heapAllocations,
+                times.imGuiAllocations);
+    if (times.heapAllocations > 0 || times.imGuiAllocations > 0)
+    {
+        std::printf("steady-allocations: FAILED, processPlots allocates on unchanged frames\n");
+        return 1;
+    }
+    return 0;
+}
+
+/// <summary>
+/// Throughput of taking in a 1 GB struct input, 16 subplots of 8 double series with x: the samples are
+/// viewed in buffers standing in for MATLAB's, then copied and prepared on the ingest workers as
+/// imGuiPlotMex does. GB/s is bytes over the wall time of the whole batch, the best of REPEATS.
+/// </summary>
+int ingestLargeStruct()
+{
+    constexpr size_t BYTES        = 1000000000;
+    constexpr size_t NUM_SUBPLOTS = 16;
+    constexpr size_t NUM_SERIES   = 8;
+    constexpr size_t NUM_SAMPLES  = BYTES / (NUM_SUBPLOTS * (NUM_SERIES + 1) * sizeof(double));
+    constexpr int    REPEATS      = 3;
+
+    std::vector<std::vector<double>>   xBuffers(NUM_SUBPLOTS, std::vector<double>(NUM_SAMPLES));
+    std::vector<std::vector<double>>   yBuffers(NUM_SUBPLOTS, std::vector<double>(NUM_SAMPLES * NUM_SERIES));
+    std::vector<ImPlot::SampleViews_t> samples(NUM_SUBPLOTS);
+    for (size_t subplot = 0; subplot < NUM_SUBPLOTS; subplot++)
+    {
+        auto& x = xBuffers[subplot];
+        auto& y = yBuffers[subplot];
+        std::iota(x.begin(), x.end(), 0.0);
+        for (size_t sample = 0; sample < y.size(); sample++)
+        {
+            y[sample] = static_cast<double>(sample % 1000) * 1e-3;
+        }
+        samples[subplot].data1 = ImPlot::MatrixView_t::of<double>(x.data(), NUM_SAMPLES, 1);
+        samples[subplot].data2 = ImPlot::MatrixView_t::of<double>(y.data(), NUM_SAMPLES, NUM_SERIES);
+    }
+
+    size_t               bytes = 0;
+    double               best  = 0.0;
+    ImPlot::ThreadPool_t workers;
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+    {
+        // each run takes in fresh subplots, as a new call would
+        std::vector<ImPlot::PlotData_t> plotData(NUM_SUBPLOTS);
+        const auto                      start = Clock_t::now();
+        workers.parallelFor(NUM_SUBPLOTS,
+                            [&](size_t subplot)
+                            {
+                                auto& data                   = plotData[subplot];
+                                data.plotInfo.data1Available = true;
+                                data.plotInfo.data2Available = true;
+                                data.plotInfo.onlyStructures = true;
+                                samples[subplot].copyTo(data);
+                                MatlabImGuiPlot::prepare(data);
+                            });
+        const double seconds = getSeconds(start);
+        best                 = repeat == 0 ? seconds : std::min(best, seconds);
+
+        bytes = 0;
+        for (const auto& subplot : samples)
+        {
+            bytes += subplot.bytes();
+        }
+    }
+
+    std::printf("ingest-1gb: %zu subplots, %zu bytes in %.1f ms wall on %zu threads, %.2f GB/s\n",
+                NUM_SUBPLOTS,
+                bytes,
+                best * 1e3,
+                workers.size() + 1,
+                bytes / best / 1e9);
+    return 0;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::string benchmark = argc > 1 ? argv[1] : "";
+
+    int result = 1;
+    if (benchmark == "render-10m")
+    {
+        result = renderLongSeries();
+    }
+    else if (benchmark == "frame-4x4")
+    {
+        result = renderSubplotGrid();
+    }
+    else if (benchmark == "steady-allocations")
+    {
+        result = renderSteadyFigure();
+    }
+    else if (benchmark == "ingest-1gb")
+    {
+        result = ingestLargeStruct();
+    }
+    else
+    {
+        std::printf("Usage: imGuiPlotBenchmarks render-10m|frame-4x4|steady-allocations|ingest-1gb\n");
+        return 1;
+    }
+
+    ImGuiContextManager::getInstance().shutdown();
+    return result;
+}
@@ -57,6 +57,7 @@ class MatlabImGuiPlot(ConanFile):
         self.requires("imgui/1.90")
         self.requires("implot/0.16")
         self.requires("opengl/system")
+        self.requires("stb/cci.20230920")
         
     def build_requirements(self):
         self.tool_requires("cmake/3.27.0")
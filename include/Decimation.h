@@ -0,0 +1,106 @@
+#pragma once
+
+/// STL headers
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace ImPlot
+{
+/// Points kept by a decimation, drawn in place of the full series
+struct DecimatedSeries_t
+{
+    std::vector<double> x;
+    std::vector<double> y;
+};
+
+/// <summary>
+/// Largest-Triangle-Three-Buckets (Steinarsson, 2013) over the samples whose x lies in [xMin, xMax],
+/// plus one neighbour on either side so lines run to the plot edge. Unlike a min/max envelope each
+/// bucket keeps the one sample that forms the largest triangle with its neighbours, so isolated
+/// outliers in scatter data survive. NaN samples are dropped, y of any type comes back as double.
+/// </summary>
+/// <param name="x">Anything indexed like an array of double with at least y.size() samples, stored or generated</param>
+/// <param name="threshold">Samples to keep, the visible samples are returned as they are if fewer</param>
+template <class X, class T>
+DecimatedSeries_t largestTriangleThreeBuckets(const X&           x,
+                                              std::span<const T> y,
+                                              double             xMin,
+                                              double             xMax,
+                                              size_t             threshold)
+{
+    const size_t numElements = y.size();
+    auto         inRange     = [&](size_t index) { return x[index] >= xMin && x[index] <= xMax; };
+
+    DecimatedSeries_t visible;
+    for (size_t index = 0; index < numElements; index++)
+    {
+        const bool keep = inRange(index) || (index > 0 && inRange(index - 1)) ||
+                          (index + 1 < numElements && inRange(index + 1));
+        const double value = static_cast<double>(y[index]);
+        if (keep && !std::isnan(x[index]) && !std::isnan(value))
+        {
+            visible.x.push_back(x[index]);
+            visible.y.push_back(value);
+        }
+    }
+
+    const size_t count = visible.x.size();
+    if (threshold < 3 || count <= threshold)
+    {
+        return visible;
+    }
+
+    DecimatedSeries_t sampled;
+    sampled.x.reserve(threshold);
+    sampled.y.reserve(threshold);
+    sampled.x.push_back(visible.x.front());
+    sampled.y.push_back(visible.y.front());
+
+    // first and last samples are always kept, the rest is split into threshold - 2 buckets
+    const double every    = static_cast<double>(count - 2) / static_cast<double>(threshold - 2);
+    size_t       selected = 0;
+    for (size_t bucket = 0; bucket < threshold - 2; bucket++)
+    {
+        // average of the next bucket is the third corner of the triangle
+        const size_t nextFirst = static_cast<size_t>(std::floor((bucket + 1) * every)) + 1;
+        const size_t nextLast  = std::min(static_cast<size_t>(std::floor((bucket + 2) * every)) + 1, count);
+        double       averageX  = 0.0;
+        double       averageY  = 0.0;
+        for (size_t index = nextFirst; index < nextLast; index++)
+        {
+            averageX += visible.x[index];
+            averageY += visible.y[index];
+        }
+        averageX /= static_cast<double>(nextLast - nextFirst);
+        averageY /= static_cast<double>(nextLast - nextFirst);
+
+        const size_t first   = static_cast<size_t>(std::floor(bucket * every)) + 1;
+        const size_t last    = static_cast<size_t>(std::floor((bucket + 1) * every)) + 1;
+        const double pointX  = visible.x[selected];
+        const double pointY  = visible.y[selected];
+        double       maxArea = -1.0;
+        size_t       chosen  = first;
+        for (size_t index = first; index < last; index++)
+        {
+            const double area = std::abs((pointX - averageX) * (visible.y[index] - pointY) -
+                                         (pointX - visible.x[index]) * (averageY - pointY));
+            if (area > maxArea)
+            {
+                maxArea = area;
+                chosen  = index;
+            }
+        }
+
+        sampled.x.push_back(visible.x[chosen]);
+        sampled.y.push_back(visible.y[chosen]);
+        selected = chosen;
+    }
+
+    sampled.x.push_back(visible.x.back());
+    sampled.y.push_back(visible.y.back());
+    return sampled;
+}
+} // namespace ImPlot
@@ -0,0 +1,177 @@
+#pragma once
+
+/// STL headers
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ImPlot
+{
+/// Frame rate a figure asks for, in frames per second. 0 follows the monitor through vsync,
+/// infinity draws as fast as possible, e.g. for benchmarking.
+struct FrameRate_t
+{
+    double focused   = 0.0;
+    double unfocused = 0.0; // while another figure or application has focus
+
+    double get(bool hasFocus) const
+    {
+        return hasFocus ? focused : unfocused;
+    }
+};
+
+/// Frame times over the last frames drawn back to back; idle gaps are left out
+struct FrameStats_t
+{
+    double target       = 0.0; // rate of the last frame, as in FrameRate_t
+    size_t frames       = 0;   // frames the times below are taken over
+    double meanInterval = 0.0; // seconds from the start of one frame to the next
+    double p99Interval  = 0.0;
+    double maxInterval  = 0.0;
+    double meanWork     = 0.0; // seconds spent building, drawing and swapping a frame
+};
+
+/// Paces the render thread to a frame rate. Frames are started on a grid of the frame period, so a
+/// sleep that overshoots does not lower the rate; a frame that is late restarts the grid. Statistics
+/// are written by the render thread and may be read from any thread.
+class FramePacer_t
+{
+  public:
+    /// <summary>
+    /// The faster of two rates; a negative rate stands for none and is slower than any. Vsync runs at
+    /// the monitor's refresh rate and is kept on a tie, as it does not tear.
+    /// </summary>
+    static double fastest(double a, double b, double refreshRate)
+    {
+        if (std::isinf(a) || std::isinf(b))
+        {
+            return INFINITY;
+        }
+        const double rateA = a == 0.0 ? refreshRate : a;
+        const double rateB = b == 0.0 ? refreshRate : b;
+        if (rateA == rateB)
+        {
+            return std::min(a, b); // vsync if one of them is
+        }
+        return rateA > rateB ? a : b;
+    }
+
+    /// <summary>
+    /// Swap interval for a rate: vsync follows the monitor, anything else is paced by sleeping
+    /// </summary>
+    static int getSwapInterval(double rate)
+    {
+        return rate == 0.0 ? 1 : 0;
+    }
+
+    /// <summary>
+    /// Sleep until the next frame at this rate is due, then start it
+    /// </summary>
+    void beginFrame(double rate)
+    {
+        const auto now = Clock_t::now();
+        if (rate > 0.0 && std::isfinite(rate) && mFrameStart != TimePoint_t())
+        {
+            const auto period = std::chrono::duration<double>(1.0 / rate);
+            mDeadline         = std::max(mDeadline + std::chrono::duration_cast<Clock_t::duration>(period), now);
+            std::this_thread::sleep_until(mDeadline);
+        }
+        else
+        {
+            mDeadline = now;
+        }
+
+        const auto start = Clock_t::now();
+        if (mFrameStart != TimePoint_t())
+        {
+            mInterval = std::chrono::duration<double>(start - mFrameStart).count();
+        }
+        mFrameStart = start;
+        mRate       = rate;
+    }
+
+    /// <summary>
+    /// Record the frame started by beginFrame, once it is swapped
+    /// </summary>
+    void endFrame()
+    {
+        const double work = std::chrono::duration<double>(Clock_t::now() - mFrameStart).count();
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTarget = mRate;
+        if (mInterval > 0.0)
+        {
+            mSamples[mNext % HISTORY] = {mInterval, work};
+            mNext++;
+        }
+        mInterval = 0.0;
+    }
+
+    /// <summary>
+    /// Nothing is drawn for now; the next frame starts at once and its interval is not counted
+    /// </summary>
+    void idle()
+    {
+        mFrameStart = TimePoint_t();
+        mInterval   = 0.0;
+    }
+
+    FrameStats_t getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        FrameStats_t                stats;
+        stats.target = mTarget;
+        stats.frames = std::min(mNext, HISTORY);
+        if (stats.frames == 0)
+        {
+            return stats;
+        }
+
+        std::vector<double> intervals(stats.frames);
+        for (size_t index = 0; index < stats.frames; index++)
+        {
+            intervals[index] = mSamples[index].interval;
+            stats.meanInterval += mSamples[index].interval;
+            stats.meanWork += mSamples[index].work;
+            stats.maxInterval = std::max(stats.maxInterval, mSamples[index].interval);
+        }
+        stats.meanInterval /= static_cast<double>(stats.frames);
+        stats.meanWork /= static_cast<double>(stats.frames);
+
+        auto p99 = intervals.begin() + static_cast<ptrdiff_t>((stats.frames - 1) * 99 / 100);
+        std::nth_element(intervals.begin(), p99, intervals.end());
+        stats.p99Interval = *p99;
+        return stats;
+    }
+
+  private:
+    using Clock_t     = std::chrono::steady_clock;
+    using TimePoint_t = Clock_t::time_point;
+
+    /// Frames the statistics are taken over
+    static constexpr size_t HISTORY = 256;
+
+    struct Sample_t
+    {
+        double interval;
+        double work;
+    };
+
+    /// Render thread only
+    TimePoint_t mDeadline;
+    TimePoint_t mFrameStart;
+    double      mInterval = 0.0;
+    double      mRate     = 0.0;
+
+    /// Shared with getStats
+    mutable std::mutex            mMutex;
+    std::array<Sample_t, HISTORY> mSamples = {};
+    size_t                        mNext    = 0;
+    double                        mTarget  = 0.0;
+};
+} // namespace ImPlot
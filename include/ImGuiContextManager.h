@@ -0,0 +1,173 @@
+#pragma once
+
+/// STL headers
+#include <atomic>
+#include <cstddef>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <iostream>
+#include <memory>
+#include <stdio.h>
+#include <vector>
+
+#include "../bindings/imgui_impl_glfw.h"
+#include "../bindings/imgui_impl_opengl3.h"
+#include "imgui.h"
+#include "implot.h"
+
+#include "OffscreenTarget.h"
+
+namespace ImPlot
+{
+/// Heap currently held by the ImGui and ImPlot contexts
+struct ContextMemory_t
+{
+    size_t bytes;
+    size_t allocations;
+};
+
+/// Hidden window for its OpenGL context, ImGui/ImPlot contexts and framebuffer of one export worker.
+/// There is no platform backend: the display size and time step are set by hand and there is no input.
+/// Only one thread may have the OpenGL context current at a time.
+struct OffscreenContext_t
+{
+    GLFWwindow*       window        = nullptr;
+    ImGuiContext*     imGuiContext  = nullptr;
+    ImPlotContext*    imPlotContext = nullptr;
+    OffscreenTarget_t target;
+};
+} // namespace ImPlot
+
+/// Owns the GLFW window and its ImGui/ImPlot contexts. They are created once,
+/// reused by every frame and every MEX call, and only destroyed on unload;
+/// closing the window just hides it. All calls must come from the render thread.
+class ImGuiContextManager
+{
+  public:
+    ImGuiContextManager(const ImGuiContextManager&)            = delete;
+    ImGuiContextManager& operator=(const ImGuiContextManager&) = delete;
+    ~ImGuiContextManager();
+
+    static ImGuiContextManager& getInstance();
+
+    /// <summary>
+    /// Create the window and contexts on first use, make them current and show the window
+    /// </summary>
+    /// <returns>The window, or NULL if it could not be created</returns>
+    GLFWwindow* acquire();
+
+    /// <summary>
+    /// Create the window and contexts on first use and make them current, leaving the window as it is.
+    /// Offscreen drawing needs nothing more, so it works with the window hidden.
+    /// </summary>
+    /// <returns>False if the window could not be created</returns>
+    bool makeCurrent();
+
+    /// <summary>
+    /// Contexts for drawing offscreen on other threads, created on first use and kept like the window's.
+    /// The window's contexts are current again on return, none of the returned ones is current.
+    /// </summary>
+    /// <returns>Up to count contexts, fewer if no more windows could be created</returns>
+    std::vector<ImPlot::OffscreenContext_t*> getOffscreenContexts(size_t count);
+
+    /// <summary>
+    /// Hide the window until the next acquire, keeping all contexts alive
+    /// </summary>
+    void release();
+
+    /// <summary>
+    /// Whether the window saw input, a resize or a repaint request since the last call
+    /// </summary>
+    bool takeWindowEvents();
+
+    /// <summary>
+    /// Whether the window is minimized, as last reported by GLFW
+    /// </summary>
+    bool isIconified() const
+    {
+        return mIconified;
+    }
+
+    /// <summary>
+    /// Whether the window has input focus, as last reported by GLFW
+    /// </summary>
+    bool isFocused() const
+    {
+        return mFocused;
+    }
+
+    /// <summary>
+    /// Refresh rate of the primary monitor in Hz, the rate vsync draws at; read when the window is shown
+    /// </summary>
+    double getRefreshRate() const
+    {
+        return mRefreshRate;
+    }
+
+    /// <summary>
+    /// Return the render thread from glfwWaitEventsTimeout; safe from any thread, a no-op until the window exists
+    /// </summary>
+    static void wake();
+
+    /// <summary>
+    /// Memory allocated through ImGui's allocator, which ImPlot shares
+    /// </summary>
+    static ImPlot::ContextMemory_t getMemoryUsage();
+
+    /// <summary>
+    /// Destroy the window and contexts; must run on the thread that acquired them
+    /// </summary>
+    void shutdown();
+
+  private:
+    ImGuiContextManager() = default;
+
+    GLFWwindow*    mWindow        = nullptr;
+    ImGuiContext*  mImGuiContext  = nullptr;
+    ImPlotContext* mImPlotContext = nullptr;
+
+    std::vector<std::unique_ptr<ImPlot::OffscreenContext_t>> mOffscreenContexts;
+
+    /// Set by the window callbacks, which run inside glfwPollEvents/glfwWaitEventsTimeout on the render thread
+    bool mWindowEvents = true;
+    bool mIconified    = false;
+    bool mFocused      = true;
+
+    /// Assumed if the monitor does not report its refresh rate
+    static constexpr double DEFAULT_REFRESH_RATE = 60.0;
+
+    double mRefreshRate = DEFAULT_REFRESH_RATE;
+
+    /// GLFW is up, so other threads may post empty events
+    static std::atomic<bool> mInitialized;
+
+    static std::atomic<size_t> mLiveBytes;
+    static std::atomic<size_t> mLiveAllocations;
+
+    /// <summary>
+    /// Counting allocator installed for both contexts
+    /// </summary>
+    static void* allocate(size_t size, void* userData);
+    static void  deallocate(void* ptr, void* userData);
+
+    /// <summary>
+    /// glfw error check by callback
+    /// </summary>
+    static void glfw_error_callback(int error, const char* description)
+    {
+        fprintf(stderr, "Glfw Error %d: %s\n", error, description);
+    }
+
+    bool initialize();
+
+    /// <summary>
+    /// Hidden window and contexts of one export worker, NULL if the window could not be created
+    /// </summary>
+    std::unique_ptr<ImPlot::OffscreenContext_t> createOffscreenContext();
+
+    /// <summary>
+    /// Note window events in mWindowEvents, minimizing and focus in mIconified and mFocused. Installed before the ImGui
+    /// backend, which chains to the ones it also uses.
+    /// </summary>
+    void installEventCallbacks();
+};
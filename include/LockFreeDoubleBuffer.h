@@ -0,0 +1,67 @@
+#pragma once
+
+/// STL headers
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace ImPlot
+{
+/// Single-producer/single-consumer hand-off of whole values. The producer
+/// fills back() and publish()es it, the consumer update()s and reads front().
+/// A third, shared slot sits between the two buffers and is swapped with a
+/// single atomic exchange, so neither side ever waits for the other: the
+/// consumer keeps drawing its front while the producer fills the back, and
+/// a value published twice before the consumer looks is simply replaced.
+template <class T>
+class LockFreeDoubleBuffer_t
+{
+  public:
+    /// <summary>
+    /// Producer side: the slot to write before publish()
+    /// </summary>
+    T& back()
+    {
+        return mSlots[mBack];
+    }
+
+    /// <summary>
+    /// Producer side: make back() visible to the consumer
+    /// </summary>
+    void publish()
+    {
+        mBack = mShared.exchange(static_cast<uint8_t>(mBack | FRESH), std::memory_order_acq_rel) & INDEX;
+    }
+
+    /// <summary>
+    /// Consumer side: swap in the latest published value
+    /// </summary>
+    /// <returns>True if front() changed</returns>
+    bool update()
+    {
+        if ((mShared.load(std::memory_order_relaxed) & FRESH) == 0)
+        {
+            return false;
+        }
+        mFront = mShared.exchange(mFront, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    /// <summary>
+    /// Consumer side: the value being displayed
+    /// </summary>
+    const T& front() const
+    {
+        return mSlots[mFront];
+    }
+
+  private:
+    static constexpr uint8_t INDEX = 0x3;
+    static constexpr uint8_t FRESH = 0x4;
+
+    std::array<T, 3>     mSlots;
+    std::atomic<uint8_t> mShared = 2; // slot index, plus FRESH once published
+    uint8_t              mBack   = 0; // owned by the producer
+    uint8_t              mFront  = 1; // owned by the consumer
+};
+} // namespace ImPlot
@@ -0,0 +1,62 @@
+#pragma once
+
+/// STL headers
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace ImPlot
+{
+/// Bounded single-producer/single-consumer FIFO. Head and tail are each
+/// written by one side only, so a push or pop is a plain store plus one
+/// release; nothing is allocated after construction. Unlike
+/// LockFreeDoubleBuffer_t every element is delivered, which is what a stream
+/// of appended samples needs.
+template <class T, size_t Capacity>
+class LockFreeQueue_t
+{
+    static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+  public:
+    /// <summary>
+    /// Producer side: move value into the queue
+    /// </summary>
+    /// <returns>False if the queue is full, value is left untouched</returns>
+    bool tryPush(T& value)
+    {
+        const size_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mHead.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+        mSlots[tail & MASK] = std::move(value);
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// <summary>
+    /// Consumer side: move the oldest value out of the queue
+    /// </summary>
+    /// <returns>False if the queue is empty</returns>
+    bool tryPop(T& value)
+    {
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mTail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        value               = std::move(mSlots[head & MASK]);
+        mSlots[head & MASK] = T();
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+  private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    std::array<T, Capacity> mSlots;
+    alignas(64) std::atomic<size_t> mHead = 0; // next slot to pop, owned by the consumer
+    alignas(64) std::atomic<size_t> mTail = 0; // next slot to push, owned by the producer
+};
+} // namespace ImPlot
@@ -3,18 +3,31 @@
 /// STL headers
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <deque>
 #include <functional>
+#include <future>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <math.h>
 #include <memory>
 #include <mutex>
 #include <numeric>
+#include <semaphore>
+#include <span>
+#include <thread>
 #include <string>
+#include <string_view>
 #include <stdio.h>
 #include <time.h>
+#include <type_traits>
+#include <variant>
 #include <vector>
 
 #include "../bindings/imgui_impl_glfw.h"
@@ -22,6 +35,15 @@
 #include "imgui.h"
 #include "implot.h"
 
+#include "Decimation.h"
+#include "FramePacer.h"
+#include "ImGuiContextManager.h"
+#include "LockFreeDoubleBuffer.h"
+#include "LockFreeQueue.h"
+#include "OffscreenTarget.h"
+#include "StyleTables.h"
+#include "ThreadPool.h"
+
 /// Miscellaneous plot info
 namespace ImPlot
 {
@@ -47,6 +69,26 @@ enum Miscellaneous_e : size_t
     LIMITS,
     UNCERN_LBOUND,
     UNCERN_UBOUND,
+    CAPACITY,
+    DECIMATION,
+    SAMPLE_RATE,
+    START_TIME,
+};
+
+/// Resolved PlotTypes entry
+enum PlotType_e : uint8_t
+{
+    LINE,
+    SCATTER,
+    BARS,
+};
+
+/// Resolved Decimation entry
+enum Decimation_e : uint8_t
+{
+    NONE,
+    MINMAX,
+    LTTB,
 };
 
 struct PlotInfo_t
@@ -63,337 +105,1557 @@ struct PlotInfo_t
     bool uncertaintyLowerBoundAvailable;
     bool uncertaintyUpperBoundAvailable;
     bool onlyStructures;
+    bool data1Available;
+    bool data2Available;
+    bool implicitX; // only data1 was given, x is generated from the sample index
+    bool capacityAvailable;
+    bool decimationAvailable;
+    bool sampleRateAvailable;
+    bool startTimeAvailable;
 };
 
-/// Plot infomations
-struct PlotData_t
+/// Data range of a series, NaN samples are ignored
+struct Bounds_t
 {
-    std::vector<std::vector<double>> data1;
-    std::vector<std::vector<double>> data2;
-    std::vector<std::string>         plotTypes;
-    std::vector<ImPlotMarker_>       markerShapes;
-    std::vector<ImVec4>              colors;
-    std::vector<double>              lineWidth;
-    std::vector<double>              markerSize;
-    std::vector<std::string>         title;
-    std::vector<std::string>         labels;
-    std::vector<std::string>         legends;
-    std::vector<double>              limits;
-    std::vector<std::vector<double>> uncertaintyLowerBound;
-    std::vector<std::vector<double>> uncertaintyUpperBound;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
 
-    PlotInfo_t plotInfo;
+    bool valid() const
+    {
+        return min <= max;
+    }
 
-    std::vector<std::vector<double>> getData1() const
+    void merge(const Bounds_t& other)
     {
-        return data1;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
     }
-    std::vector<std::vector<double>> getData2() const
+};
+
+/// Single pass min/max. Four independent lanes keep the loop free of
+/// cross-iteration dependencies so it vectorizes (minpd/maxpd); a NaN fails
+/// both comparisons and never replaces a lane value.
+template <class T>
+Bounds_t getBounds(std::span<const T> data)
+{
+    constexpr size_t lanes = 4;
+    double           lo[lanes];
+    double           hi[lanes];
+    std::fill(lo, lo + lanes, std::numeric_limits<double>::infinity());
+    std::fill(hi, hi + lanes, -std::numeric_limits<double>::infinity());
+
+    size_t index = 0;
+    for (; index + lanes <= data.size(); index += lanes)
     {
-        return data2;
+        for (size_t lane = 0; lane < lanes; lane++)
+        {
+            const double value = static_cast<double>(data[index + lane]);
+            lo[lane]           = value < lo[lane] ? value : lo[lane];
+            hi[lane]           = value > hi[lane] ? value : hi[lane];
+        }
     }
-    std::vector<std::string> getPlotTypes() const
+    for (; index < data.size(); index++)
     {
-        return plotTypes;
+        const double value = static_cast<double>(data[index]);
+        lo[0]              = value < lo[0] ? value : lo[0];
+        hi[0]              = value > hi[0] ? value : hi[0];
     }
-    std::vector<ImPlotMarker_> getMarkerShapes() const
+
+    Bounds_t bounds = {};
+    for (size_t lane = 0; lane < lanes; lane++)
     {
-        return markerShapes;
+        bounds.merge({lo[lane], hi[lane]});
     }
-    std::vector<ImVec4> getColors() const
+    return bounds;
+}
+
+/// Distance from an even grid still taken as on it, as a fraction of the step: far below a pixel whenever
+/// there are more samples than pixels to decimate
+constexpr double EVEN_SPACING_TOLERANCE = 1e-3;
+
+/// <summary>
+/// Whether x increases by the same step from each sample to the next, within EVEN_SPACING_TOLERANCE
+/// </summary>
+inline bool isEvenlySpaced(std::span<const double> x)
+{
+    if (x.size() < 2)
     {
-        return colors;
+        return true;
     }
-    std::vector<double> getLineWidth() const
+    const double step = (x.back() - x.front()) / static_cast<double>(x.size() - 1);
+    if (!(step > 0.0) || !std::isfinite(step))
     {
-        return lineWidth;
+        return false;
     }
-    std::vector<double> getMarkerSize() const
+    const double tolerance = EVEN_SPACING_TOLERANCE * step;
+    for (size_t sample = 1; sample < x.size(); sample++)
     {
-        return markerSize;
+        // NaN fails the comparison as well
+        if (!(std::abs(x[sample] - (x.front() + step * static_cast<double>(sample))) <= tolerance))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Column-major series storage: one contiguous buffer per field (as MATLAB
+/// lays out a matrix) and the offset of every series inside it. The buffer is
+/// immutable once assigned and shared by copies, so copying a PlotData_t to
+/// change a few fields never duplicates sample data.
+template <class T>
+struct ColumnMatrix_t
+{
+    typedef T value_type;
+
+    std::shared_ptr<const std::vector<T>> values;
+    std::vector<size_t>   offsets;
+    size_t                rows = 0;
+    std::vector<Bounds_t> bounds;      // per series, cached at ingest
+    Bounds_t              totalBounds; // union of all series
+
+    /// Number of series
+    size_t size() const
+    {
+        return offsets.size();
     }
-    std::vector<std::string> getTitle() const
+
+    bool empty() const
     {
-        return title;
+        return offsets.empty();
     }
-    std::vector<std::string> getLabels() const
+
+    std::span<const T> operator[](size_t index) const
     {
-        return labels;
+        return std::span<const T>(values->data() + offsets[index], rows);
     }
-    std::vector<std::string> getLegends() const
+
+    std::span<const T> at(size_t index) const
     {
-        return legends;
+        return std::span<const T>(values->data() + offsets.at(index), rows);
     }
-    std::vector<double> getLimits() const
+
+    /// Take a whole column-major matrix in one allocation
+    template <class It>
+    void assign(It first, It last, size_t numRows, size_t numColumns)
     {
-        return limits;
+        assign(std::vector<T>(first, last), numRows, numColumns);
     }
-    std::vector<std::vector<double>> getUncertaintyLowerBound() const
+
+    void assign(std::vector<T>&& data, size_t numRows, size_t numColumns)
     {
-        return uncertaintyLowerBound;
+        values = std::make_shared<const std::vector<T>>(std::move(data));
+        rows   = numRows;
+        offsets.resize(numColumns);
+        for (size_t column = 0; column < numColumns; column++)
+        {
+            offsets[column] = column * numRows;
+        }
+        updateBounds();
     }
-    std::vector<std::vector<double>> getUncertaintyUpperBound() const
+
+    /// Recompute the cached bounds, needed whenever values change
+    void updateBounds()
     {
-        return uncertaintyUpperBound;
+        bounds.resize(offsets.size());
+        totalBounds = {};
+        for (size_t index = 0; index < offsets.size(); index++)
+        {
+            bounds[index] = getBounds((*this)[index]);
+            totalBounds.merge(bounds[index]);
+        }
     }
 
-    PlotInfo_t getPlotInfo() const
+    /// <summary>
+    /// A single column used by numColumns series, as MATLAB expands one time base against many signals.
+    /// Every series points at the same samples, nothing is copied.
+    /// </summary>
+    void broadcast(size_t numColumns)
     {
-        return plotInfo;
+        if (offsets.size() == 1 && numColumns > 1)
+        {
+            offsets.assign(numColumns, offsets[0]);
+            bounds.assign(numColumns, bounds[0]);
+        }
+    }
+
+    /// <summary>
+    /// Keep one copy of columns holding the same samples bit for bit; the series of a dropped
+    /// copy point at the one kept. Cached bounds rule out most pairs without comparing samples.
+    /// </summary>
+    void shareIdenticalColumns()
+    {
+        std::vector<size_t> unique;        // first series of every distinct column
+        std::vector<size_t> owner(size()); // series whose samples each series ends up with
+        bool                duplicates = false;
+        for (size_t index = 0; index < size(); index++)
+        {
+            owner[index] = index;
+            for (size_t candidate : unique)
+            {
+                if (offsets[candidate] == offsets[index])
+                {
+                    owner[index] = candidate; // already shared, e.g. broadcast
+                    break;
+                }
+                if (bounds[candidate].min == bounds[index].min && bounds[candidate].max == bounds[index].max &&
+                    std::memcmp((*this)[candidate].data(), (*this)[index].data(), rows * sizeof(T)) == 0)
+                {
+                    owner[index] = candidate;
+                    duplicates   = true;
+                    break;
+                }
+            }
+            if (owner[index] == index)
+            {
+                unique.push_back(index);
+            }
+        }
+        if (!duplicates)
+        {
+            return;
+        }
+
+        std::vector<T>      compact;
+        std::vector<size_t> compactOffsets(size());
+        compact.reserve(unique.size() * rows);
+        for (size_t candidate : unique)
+        {
+            compactOffsets[candidate] = compact.size();
+            compact.insert(compact.end(), (*this)[candidate].begin(), (*this)[candidate].end());
+        }
+        for (size_t index = 0; index < size(); index++)
+        {
+            compactOffsets[index] = compactOffsets[owner[index]];
+        }
+        values  = std::make_shared<const std::vector<T>>(std::move(compact));
+        offsets = std::move(compactOffsets);
     }
 };
 
-struct MatlabInput_t
+/// One series of any element type ImPlot plots natively. 64-bit integers are ImS64/ImU64 (long long), the
+/// types ImPlot instantiates, which differ from int64_t/uint64_t (long) on LP64 platforms.
+typedef std::variant<std::span<const double>,
+                     std::span<const float>,
+                     std::span<const int8_t>,
+                     std::span<const uint8_t>,
+                     std::span<const int16_t>,
+                     std::span<const uint16_t>,
+                     std::span<const int32_t>,
+                     std::span<const uint32_t>,
+                     std::span<const ImS64>,
+                     std::span<const ImU64>>
+    SeriesSpan_t;
+
+/// y data in the element type MATLAB passed it in, so a single or int16
+/// capture takes the same memory here as in MATLAB. x stays double.
+struct SeriesMatrix_t
 {
-    std::string             figureConfig;
-    std::vector<double>     subModuleDimensions;
-    std::vector<PlotData_t> plotData;
+    typedef std::variant<ColumnMatrix_t<double>,
+                         ColumnMatrix_t<float>,
+                         ColumnMatrix_t<int8_t>,
+                         ColumnMatrix_t<uint8_t>,
+                         ColumnMatrix_t<int16_t>,
+                         ColumnMatrix_t<uint16_t>,
+                         ColumnMatrix_t<int32_t>,
+                         ColumnMatrix_t<uint32_t>,
+                         ColumnMatrix_t<ImS64>,
+                         ColumnMatrix_t<ImU64>>
+        Matrix_t;
+
+    Matrix_t matrix;
 
-    std::string getMatlabFigureNames() const
+    SeriesMatrix_t() = default;
+
+    template <class T>
+    SeriesMatrix_t(ColumnMatrix_t<T> other)
+        : matrix(std::move(other))
     {
-        return figureConfig;
     }
 
-    std::vector<double> getSubModuleDimensions() const
+    /// Call f with the ColumnMatrix_t<T> held
+    template <class F>
+    decltype(auto) visit(F&& f) const
     {
-        return subModuleDimensions;
+        return std::visit(std::forward<F>(f), matrix);
     }
 
-    std::vector<PlotData_t> getMatlabPlotData() const
+    /// Number of series
+    size_t size() const
     {
-        return plotData;
+        return visit([](const auto& columns) { return columns.size(); });
     }
-};
 
-} // namespace ImPlot
+    size_t rows() const
+    {
+        return visit([](const auto& columns) { return columns.rows; });
+    }
 
-class MatlabImGuiPlot
-{
-  public:
-    MatlabImGuiPlot() = default;
-    MatlabImGuiPlot(std::vector<ImPlot::MatlabInput_t>& data);
-    ~MatlabImGuiPlot(){};
+    SeriesSpan_t operator[](size_t index) const
+    {
+        return visit([index](const auto& columns) { return SeriesSpan_t(columns[index]); });
+    }
 
-    static std::vector<std::string> getAvailableInputVariableNames()
+    const Bounds_t& totalBounds() const
     {
-        return {
-            "PlotTypes",
-            "MarkerShapes",
-            "Colors",
-            "LineWidths",
-            "MarkerSizes",
-            "Title",
-            "Labels",
-            "Legends",
-            "Limits",
-            "UncertaintyLowerBound",
-            "UncertaintyUpperBound",
-        };
+        return visit([](const auto& columns) -> const Bounds_t& { return columns.totalBounds; });
     }
 
-    static std::vector<std::string> getAvailablePlotTypes()
+    /// The shared sample buffer, equal for matrices that share it
+    std::shared_ptr<const void> buffer() const
     {
-        return {
-            "Line",
-            "Scatter",
-            "Bars",
-        };
+        return visit([](const auto& columns) { return std::shared_ptr<const void>(columns.values); });
     }
 
-    static std::map<std::string, ImVec4> getAvailableColorTypes()
+    /// Same samples as double, for y data that turns out to be x. Shared, not copied, if already double.
+    ColumnMatrix_t<double> toDouble() const
     {
-        return {
+        return visit(
+            [](const auto& columns)
+            {
+                typedef typename std::decay_t<decltype(columns)>::value_type Element_t;
+                if constexpr (std::is_same_v<Element_t, double>)
+                {
+                    return columns;
+                }
+                else
+                {
+                    std::vector<double> values;
+                    values.reserve(columns.rows * columns.size());
+                    for (size_t index = 0; index < columns.size(); index++)
+                    {
+                        values.insert(values.end(), columns[index].begin(), columns[index].end());
+                    }
+                    ColumnMatrix_t<double> converted;
+                    converted.assign(std::move(values), columns.rows, columns.size());
+                    return converted;
+                }
+            });
+    }
+};
+
+/// x of a series: the stored samples, or for implicit x (values is NULL)
+/// sample i at start + i * scale, generated when drawn and never stored.
+struct XData_t
+{
+    const double* values = NULL;
+    double        start  = 1.0;
+    double        scale  = 1.0;
 
-            {"Background", ImVec4(0.800f, 0.800f, 0.800f, 1.00f)},
-            {"LightGray", ImVec4(0.800f, 0.800f, 0.800f, 1.00f)},
-            {"Gray", ImVec4(0.502f, 0.502f, 0.502f, 1.00f)},
-            {"Indigo", ImVec4(0.294f, 0.000f, 0.510f, 1.00f)},
-            {"BlueViolet", ImVec4(0.541f, 0.169f, 0.886f, 1.00f)},
-            {"DarkestBlue", ImVec4(0.000f, 0.000f, 0.500f, 1.00f)},
-            {"DarkBlue", ImVec4(0.000f, 0.000f, 0.750f, 1.00f)},
-            {"Blue", ImVec4(0.000f, 0.000f, 1.000f, 1.00f)},
-            {"LightBlue", ImVec4(0.350f, 0.350f, 1.000f, 1.00f)},
-            {"DodgerBlue", ImVec4(0.118f, 0.565f, 1.000f, 1.00f)},
-            {"Cyan", ImVec4(0.000f, 1.000f, 1.000f, 1.00f)},
-            {"DarkCyan", ImVec4(0.000f, 0.600f, 0.600f, 1.00f)},
-            {"Lime", ImVec4(0.000f, 1.000f, 0.000f, 1.00f)},
-            {"Green", ImVec4(0.000f, 0.800f, 0.000f, 1.00f)},
-            {"LightGreen", ImVec4(0.000f, 1.000f, 0.000f, 1.00f)},
-            {"DarkGreen", ImVec4(0.000f, 0.600f, 0.000f, 1.00f)},
-            {"Yellow", ImVec4(1.000f, 1.000f, 0.000f, 1.00f)},
-            {"DarkYellow", ImVec4(0.700f, 0.700f, 0.000f, 1.00f)},
-            {"Orange", ImVec4(1.000f, 0.647f, 0.000f, 1.00f)},
-            {"Red", ImVec4(1.000f, 0.000f, 0.000f, 1.00f)},
-            {"DarkRed", ImVec4(0.700f, 0.000f, 0.000f, 1.00f)},
-            {"Brown", ImVec4(0.545f, 0.000f, 0.000f, 1.00f)},
-            {"Magenta", ImVec4(1.000f, 0.000f, 1.000f, 1.00f)},
-            {"DarkMagenta", ImVec4(0.600f, 0.000f, 0.600f, 1.00f)},
-            {"Black", ImVec4(0.000f, 0.000f, 0.000f, 1.00f)},
-            {"White", ImVec4(1.000f, 1.000f, 1.000f, 1.00f)},
-            {"IndianRed", ImVec4(0.80F, 0.36F, 0.36F, 1.00f)},
-            {"MediumVioletRed", ImVec4(0.7804F, 0.0824F, 0.5216F, 1.00f)},
-            {"OrangeRed", ImVec4(1.0F, 0.27F, 0.0F, 1.00f)},
-            {"VioletRed", ImVec4(0.97F, 0.33F, 0.58F, 1.00f)},
-            {"DarkOliveGreen", ImVec4(0.33F, 0.42F, 0.18F, 1.00f)},
-            {"ForestGreen", ImVec4(0.137255F, 0.556863F, 0.137255F, 1.00f)},
-            {"GreenYellow", ImVec4(0.68F, 1.0F, 0.18F, 1.00f)},
-            {"LimeGreen", ImVec4(0.196078F, 0.8F, 0.196078F, 1.00f)},
-            {"OliveDrab", ImVec4(0.419608F, 0.556863F, 0.137255F, 1.00f)},
-            {"MediumSeaGreen", ImVec4(0.24F, 0.7F, 0.44F, 1.00f)},
-            {"MediumSpringGreen", ImVec4(0.0F, 0.98F, 0.6F, 1.00f)},
-            {"PaleGreen", ImVec4(0.60F, 0.98F, 0.60F, 1.00f)},
-            {"SeaGreen", ImVec4(0.18F, 0.55F, 0.34F, 1.00f)},
-            {"SpringGreen", ImVec4(0.0F, 1.0F, 0.498039F, 1.00f)},
-            {"YellowGreen", ImVec4(0.6F, 0.8F, 0.196078F, 1.00f)},
-            {"GreenCopper", ImVec4(0.32F, 0.49F, 0.46F, 1.00f)},
-            {"DarkGreenCopper", ImVec4(0.29F, 0.46F, 0.43F, 1.00f)},
-            {"HuntersGreen", ImVec4(0.21F, 0.37F, 0.23F, 1.00f)},
-            {"CadetBlue", ImVec4(0.372549F, 0.623529F, 0.623529F, 1.00f)},
-            {"CornflowerBlue", ImVec4(0.39F, 0.58F, 0.93F, 1.00f)},
-            {"DarkSlateBlue", ImVec4(0.28F, 0.24F, 0.55F, 1.00f)},
-            {"LightSteelBlue", ImVec4(0.27F, 0.51F, 0.71F, 1.00f)},
-            {"MediumBlue", ImVec4(0.0F, 0.0F, 0.8F, 1.00f)},
-            {"MediumSlateBlue", ImVec4(0.48F, 0.41F, 0.93F, 1.00f)},
-            {"MidnightBlue", ImVec4(0.10F, 0.10F, 0.44F, 1.00f)},
-            {"NavyBlue", ImVec4(0.0F, 0.0F, 0.50F, 1.00f)},
-            {"SkyBlue", ImVec4(0.53F, 0.81F, 0.92F, 1.00f)},
-            {"SlateBlue", ImVec4(0.42F, 0.35F, 0.80F, 1.00f)},
-            {"SteelBlue", ImVec4(0.27F, 0.51F, 0.71F, 1.00f)},
-            {"RichBlue", ImVec4(0.35F, 0.35F, 0.67F, 1.00f)},
-            {"NeonBlue", ImVec4(0.27F, 0.40F, 1.0F, 1.00f)},
-            {"NewMidnightBlue", ImVec4(0.00F, 0.00F, 0.61F, 1.00f)},
-            {"DimGray", ImVec4(0.41F, 0.41F, 0.41F, 1.00f)},
-            {"VLightGray", ImVec4(0.83F, 0.83F, 0.83F, 1.00f)},
-            {"DarkSlateGray", ImVec4(0.184314F, 0.309804F, 0.309804F, 1.00f)},
-            {"MandarinOrange", ImVec4(0.96F, 0.60F, 0.02F, 1.00f)},
-            {"Aquamarine", ImVec4(0.50F, 1.0F, 0.83F, 1.00f)},
-            {"Coral", ImVec4(1.0F, 0.498039F, 0.31F, 1.00f)},
-            {"DarkOrchid", ImVec4(0.6F, 0.196078F, 0.8F, 1.00f)},
-            {"DarkTurquoise", ImVec4(0.0F, 0.81F, 0.82F, 1.00f)},
-            {"Firebrick", ImVec4(0.70F, 0.13F, 0.13F, 1.00f)},
-            {"Gold", ImVec4(1.0F, 0.84F, 0.0F, 1.00f)},
-            {"Goldenrod", ImVec4(0.85F, 0.65F, 0.13F, 1.00f)},
-            {"Khaki", ImVec4(0.94F, 0.90F, 0.55F, 1.00f)},
-            {"Maroon", ImVec4(0.50F, 0.0F, 0.0F, 1.00f)},
-            {"MediumAquamarine", ImVec4(0.4F, 0.8F, 0.67F, 1.00f)},
-            {"MediumGoldenrod", ImVec4(0.917647F, 0.917647F, 0.678431F, 1.00f)},
-            {"MediumOrchid", ImVec4(0.73F, 0.33F, 0.83F, 1.00f)},
-            {"MediumTurquoise", ImVec4(0.28F, 0.82F, 0.80F, 1.00f)},
-            {"Orchid", ImVec4(0.858824F, 0.439216F, 0.858824F, 1.00f)},
-            {"Pink", ImVec4(1.0F, 0.75F, 0.80F, 1.00f)},
-            {"Plum", ImVec4(0.87F, 0.63F, 0.87F, 1.00f)},
-            {"Salmon", ImVec4(0.98F, 0.50F, 0.45F, 1.00f)},
-            {"Sienna", ImVec4(0.63F, 0.32F, 0.18F, 1.00f)},
-            {"Tan", ImVec4(0.82F, 0.71F, 0.55F, 1.00f)},
-            {"Thistle", ImVec4(0.847059F, 0.74902F, 0.847059F, 1.00f)},
-            {"Turquoise", ImVec4(0.25F, 0.88F, 0.82F, 1.00f)},
-            {"Violet", ImVec4(0.93F, 0.51F, 0.93F, 1.00f)},
-            {"Wheat", ImVec4(0.96F, 0.87F, 0.70F, 1.00f)},
-            {"SummerSky", ImVec4(0.22F, 0.69F, 0.87F, 1.00f)},
-            {"Brass", ImVec4(0.71F, 0.65F, 0.26F, 1.00f)},
-            {"Copper", ImVec4(0.72F, 0.45F, 0.20F, 1.00f)},
-            {"Bronze", ImVec4(0.8F, 0.5F, 0.2F, 1.00f)},
-            {"Silver", ImVec4(0.75F, 0.75F, 0.75F, 1.00f)},
-            {"BrightGold", ImVec4(0.82F, 0.63F, 0.29F, 1.00f)},
-            {"OldGold", ImVec4(0.81F, 0.71F, 0.23F, 1.00f)},
-            {"Feldspar", ImVec4(0.82F, 0.57F, 0.46F, 1.00f)},
-            {"Quartz", ImVec4(0.32F, 0.28F, 0.31F, 1.00f)},
-            {"NeonPink", ImVec4(1.00F, 0.43F, 0.78F, 1.00f)},
-            {"DarkPurple", ImVec4(0.19F, 0.10F, 0.20F, 1.00f)},
-            {"CoolCopper", ImVec4(0.85F, 0.53F, 0.10F, 1.00f)},
-            {"LightWood", ImVec4(0.91F, 0.76F, 0.65F, 1.00f)},
-            {"MediumWood", ImVec4(0.65F, 0.50F, 0.39F, 1.00f)},
-            {"DarkWood", ImVec4(0.52F, 0.37F, 0.26F, 1.00f)},
-            {"SpicyPink", ImVec4(1.00F, 0.11F, 0.68F, 1.00f)},
-            {"SemiSweetChocolate", ImVec4(0.42F, 0.26F, 0.15F, 1.00f)},
-            {"BakersChocolate", ImVec4(0.36F, 0.20F, 0.09F, 1.00f)},
-            {"Flesh", ImVec4(0.96F, 0.80F, 0.69F, 1.00f)},
-            {"NewTan", ImVec4(0.92F, 0.78F, 0.62F, 1.00f)},
-            {"VeryDarkBrown", ImVec4(0.35F, 0.16F, 0.14F, 1.00f)},
-            {"DarkBrown", ImVec4(0.36F, 0.25F, 0.20F, 1.00f)},
-            {"DarkTan", ImVec4(0.59F, 0.41F, 0.31F, 1.00f)},
-            {"DustyRose", ImVec4(0.52F, 0.39F, 0.39F, 1.00f)},
-            {"Scarlet", ImVec4(1.0F, 0.14F, 0.0F, 1.00f)},
-            {"MediumPurple", ImVec4(0.58F, 0.44F, 0.86F, 1.00f)},
-            {"LightPurple", ImVec4(0.87F, 0.58F, 0.98F, 1.00f)},
-            {"VeryLightPurple", ImVec4(0.94F, 0.81F, 0.99F, 1.00f)}};
-    }
-
-    static std::map<std::array<std::string, 2U>, ImPlotMarker_> getAvailableMarkerInfo()
+    double operator[](size_t index) const
     {
-        return {
-            {{"o", "circle"}, ImPlotMarker_Circle},
-            {{"s", "square"}, ImPlotMarker_Square},
-            {{"d", "diamond"}, ImPlotMarker_Diamond},
-            {{"^", "triangle (up)"}, ImPlotMarker_Up},
-            {{"v", "triangle (down)"}, ImPlotMarker_Down},
-            {{"<", "triangle (left)"}, ImPlotMarker_Left},
-            {{">", "triangle (right)"}, ImPlotMarker_Right},
-            {{"x", "x-mark"}, ImPlotMarker_Cross},
-            {{"+", "plus"}, ImPlotMarker_Plus},
-            {{"*", "star"}, ImPlotMarker_Asterisk},
-        };
+        return values ? values[index] : start + scale * static_cast<double>(index);
     }
 
-  private:
-    std::mutex mtx; // mutex for critical section
+    /// Same x, starting at sample first
+    XData_t from(size_t first) const
+    {
+        return values ? XData_t{values + first, start, scale} : XData_t{NULL, (*this)[first], scale};
+    }
+};
+
+/// Column-major matrix read in place from the buffer of a MATLAB array. Taken on the MEX thread while the
+/// array is alive, so that the workers copying it read plain memory and never touch a MATLAB array.
+struct MatrixView_t
+{
+    const void* data    = NULL;
+    size_t      rows    = 0;
+    size_t      columns = 0;
+    size_t      bytes   = 0;
+    SeriesMatrix_t (*copy)(const MatrixView_t& view) = NULL;
 
     /// <summary>
-    /// Copy vector from std::vector to data[]
+    /// View of rows x columns elements of MATLAB class Element_t, stored as Stored_t of the same size
     /// </summary>
-    template <class T>
-    void copyVector(std::vector<T>& vec, T data[])
+    template <class Element_t, class Stored_t = Element_t>
+    static MatrixView_t of(const Element_t* data, size_t rows, size_t columns)
+    {
+        static_assert(sizeof(Element_t) == sizeof(Stored_t));
+        return {data, rows, columns, rows * columns * sizeof(Element_t), &copyAs<Element_t, Stored_t>};
+    }
+
+    /// Copy of the elements in a matrix of their own type, empty for an empty view
+    SeriesMatrix_t toMatrix() const
+    {
+        return copy ? copy(*this) : SeriesMatrix_t();
+    }
+
+  private:
+    template <class Element_t, class Stored_t>
+    static SeriesMatrix_t copyAs(const MatrixView_t& view)
+    {
+        // element-wise, so MATLAB's int64 is converted to ImS64 rather than reinterpreted
+        const Element_t*         first = static_cast<const Element_t*>(view.data);
+        ColumnMatrix_t<Stored_t> matrix;
+        matrix.assign(first, first + view.rows * view.columns, view.rows, view.columns);
+        return matrix;
+    }
+};
+
+/// Fixed-capacity history of one streamed series, y in the type the subplot was
+/// created with. Samples are written in a circle and drawn with ImPlot's offset
+/// argument, so nothing is ever moved. Bounds and the samples of the smallest and
+/// largest y are kept per block of BLOCK_SIZE samples: an append rescans only the
+/// blocks it wrote, the totals are the union of the block summaries, and a ring
+/// much longer than the plot is wide is drawn from the block summaries alone.
+template <class T>
+class RingBuffer_t
+{
+  public:
+    static constexpr size_t BLOCK_SIZE = 256;
+
+    typedef T value_type;
+
+    RingBuffer_t() = default;
+
+    explicit RingBuffer_t(size_t capacity)
+        : mX(capacity)
+        , mY(capacity)
+        , mXBlocks((capacity + BLOCK_SIZE - 1) / BLOCK_SIZE)
+        , mYBlocks((capacity + BLOCK_SIZE - 1) / BLOCK_SIZE)
+        , mYExtremes((capacity + BLOCK_SIZE - 1) / BLOCK_SIZE)
     {
-        size_t index = 0;
-        for (auto v : vec)
-        {
-            data[index] = v;
-            index++;
-        }
     }
 
     /// <summary>
-    /// Plotting data errors check
+    /// Push samples, overwriting the oldest once full. Only the last capacity() samples are kept.
     /// </summary>
-    void errorCheck(ImPlot::PlotData_t& data);
+    template <class U>
+    void append(std::span<const double> x, std::span<const U> y)
+    {
+        append(XData_t{x.data()}, y.first(std::min(x.size(), y.size())));
+    }
 
     /// <summary>
-    /// glfw error check by callback
+    /// Push samples with x generated or stored, x[0] belongs to y[0]. y of another type is converted.
     /// </summary>
-    static void glfw_error_callback(int error, const char* description)
+    template <class U>
+    void append(const XData_t& x, std::span<const U> y)
     {
-        fprintf(stderr, "Glfw Error %d: %s\n", error, description);
+        const size_t capacity = mX.size();
+        size_t       count    = y.size();
+        mCount += count;
+        if (capacity == 0 || count == 0)
+        {
+            return;
+        }
+
+        // older samples would be overwritten by this same call
+        const size_t skip = count > capacity ? count - capacity : 0;
+        count -= skip;
+        if (skip > 0)
+        {
+            // nothing held before is left, nor is its spacing
+            mLastX         = std::numeric_limits<double>::quiet_NaN();
+            mStep          = std::numeric_limits<double>::quiet_NaN();
+            mEvenlySpacedX = true;
+        }
+
+        const size_t start = mHead;
+        for (size_t index = 0; index < count; index++)
+        {
+            const double value = x[skip + index];
+            if (mEvenlySpacedX && !std::isnan(mLastX))
+            {
+                // the first step taken sets the one every later step must match
+                const double step = value - mLastX;
+                mStep             = std::isnan(mStep) ? step : mStep;
+                mEvenlySpacedX    = step > 0.0 && std::abs(step - mStep) <= EVEN_SPACING_TOLERANCE * mStep;
+            }
+            mLastX = value;
+
+            mX[mHead] = value;
+            mY[mHead] = static_cast<T>(y[skip + index]);
+            mHead     = mHead + 1 == capacity ? 0 : mHead + 1;
+        }
+        mSize = std::min(mSize + count, capacity);
+
+        // rescan the blocks written: start to the end of the buffer, then the part wrapped to the front
+        const size_t numBlocks = mXBlocks.size();
+        const size_t end       = std::min(start + count, capacity);
+        for (size_t block = start / BLOCK_SIZE; block <= (end - 1) / BLOCK_SIZE; block++)
+        {
+            updateBlock(block);
+        }
+        if (start + count > capacity)
+        {
+            for (size_t block = 0; block <= (start + count - capacity - 1) / BLOCK_SIZE; block++)
+            {
+                updateBlock(block);
+            }
+        }
+
+        mXBounds = {};
+        mYBounds = {};
+        for (size_t block = 0; block < numBlocks; block++)
+        {
+            mXBounds.merge(mXBlocks[block]);
+            mYBounds.merge(mYBlocks[block]);
+        }
     }
 
     /// <summary>
-    /// Find the min max values of x and y data limits
+    /// Samples to draw instead of all of them: for each of about buckets runs of whole blocks, oldest first,
+    /// the sample of the smallest and of the largest y in the order they were taken in. Only a ring whose x
+    /// steps evenly and that holds at least one block per bucket is decimated, otherwise the result is empty.
     /// </summary>
-    template <class T>
-    void getDataMinMax(const std::vector<std::vector<T>>& data, T& min, T& max)
+    /// <returns>Indices into x() and y(), valid until the next call on this thread</returns>
+    std::span<const size_t> select(size_t buckets) const
     {
-        std::vector<T> internalVector = {};
-        for (auto& dv : data)
+        static thread_local std::vector<size_t> samples;
+        samples.clear();
+
+        const size_t capacity  = mY.size();
+        const size_t numBlocks = (mSize + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        if (!mEvenlySpacedX || buckets == 0 || numBlocks < buckets)
+        {
+            return {};
+        }
+
+        // a NaN sample is only kept when the whole bucket is NaN
+        auto lower = [this](size_t a, size_t b) { return std::isnan(mY[a]) || mY[b] < mY[a] ? b : a; };
+        auto upper = [this](size_t a, size_t b) { return std::isnan(mY[a]) || mY[b] > mY[a] ? b : a; };
+
+        const size_t perBucket = (numBlocks + buckets - 1) / buckets;
+        const size_t oldest    = offset();
+        size_t       units     = 0;
+        size_t       lo        = 0;
+        size_t       hi        = 0;
+        auto         flush     = [&]()
+        {
+            if (units > 0)
+            {
+                const bool loFirst = (lo + capacity - oldest) % capacity <= (hi + capacity - oldest) % capacity;
+                samples.push_back(loFirst ? lo : hi);
+                samples.push_back(loFirst ? hi : lo);
+                units = 0;
+            }
+        };
+        auto take = [&](size_t unitLo, size_t unitHi)
+        {
+            lo = units == 0 ? unitLo : lower(lo, unitLo);
+            hi = units == 0 ? unitHi : upper(hi, unitHi);
+            if (++units == perBucket)
+            {
+                flush();
+            }
+        };
+        auto takeBlock = [&](size_t block)
+        {
+            take(block * BLOCK_SIZE + mYExtremes[block][0], block * BLOCK_SIZE + mYExtremes[block][1]);
+        };
+        auto takeSamples = [&](size_t begin, size_t end)
+        {
+            size_t unitLo = begin;
+            size_t unitHi = begin;
+            for (size_t index = begin + 1; index < end; index++)
+            {
+                unitLo = lower(unitLo, index);
+                unitHi = upper(unitHi, index);
+            }
+            take(unitLo, unitHi);
+        };
+
+        const size_t headBlock = mHead / BLOCK_SIZE;
+        if (mSize == capacity && mHead % BLOCK_SIZE != 0)
+        {
+            // the block written last holds the newest samples before the head and the oldest after it
+            takeSamples(mHead, std::min((headBlock + 1) * BLOCK_SIZE, capacity));
+            for (size_t block = headBlock + 1; block < numBlocks; block++)
+            {
+                takeBlock(block);
+            }
+            for (size_t block = 0; block < headBlock; block++)
+            {
+                takeBlock(block);
+            }
+            takeSamples(headBlock * BLOCK_SIZE, mHead);
+        }
+        else
         {
-            for (auto& d : dv)
+            for (size_t block = 0; block < numBlocks; block++)
             {
-                internalVector.push_back(d);
+                takeBlock((oldest / BLOCK_SIZE + block) % numBlocks);
             }
         }
-        if (internalVector.size() > 0)
+        flush();
+        return samples;
+    }
+
+    /// Samples held, at most capacity()
+    size_t size() const
+    {
+        return mSize;
+    }
+
+    size_t capacity() const
+    {
+        return mX.size();
+    }
+
+    /// Samples appended since construction, including the ones overwritten
+    uint64_t count() const
+    {
+        return mCount;
+    }
+
+    /// Index of the oldest sample, the offset ImPlot starts drawing from
+    size_t offset() const
+    {
+        return mSize < mX.size() ? 0 : mHead;
+    }
+
+    const double* x() const
+    {
+        return mX.data();
+    }
+
+    const T* y() const
+    {
+        return mY.data();
+    }
+
+    const Bounds_t& xBounds() const
+    {
+        return mXBounds;
+    }
+
+    const Bounds_t& yBounds() const
+    {
+        return mYBounds;
+    }
+
+  private:
+    void updateBlock(size_t block)
+    {
+        // until the first wrap only [0, size) holds samples
+        const size_t begin = block * BLOCK_SIZE;
+        const size_t end   = std::min(begin + BLOCK_SIZE, mSize);
+        const size_t rows  = end > begin ? end - begin : 0;
+        mXBlocks[block]    = getBounds(std::span<const double>(mX.data() + begin, rows));
+        mYBlocks[block]    = getBounds(std::span<const T>(mY.data() + begin, rows));
+
+        uint16_t lo = 0;
+        uint16_t hi = 0;
+        for (uint16_t index = 1; index < rows; index++)
+        {
+            const T value = mY[begin + index];
+            lo            = std::isnan(mY[begin + lo]) || value < mY[begin + lo] ? index : lo;
+            hi            = std::isnan(mY[begin + hi]) || value > mY[begin + hi] ? index : hi;
+        }
+        mYExtremes[block] = {lo, hi};
+    }
+
+    std::vector<double>                   mX;
+    std::vector<T>                        mY;
+    std::vector<Bounds_t>                 mXBlocks;
+    std::vector<Bounds_t>                 mYBlocks;
+    std::vector<std::array<uint16_t, 2>> mYExtremes; // smallest and largest y, counted from the block start
+    Bounds_t                              mXBounds;
+    Bounds_t                              mYBounds;
+    size_t                                mHead          = 0; // next slot to write
+    size_t                                mSize          = 0;
+    uint64_t                              mCount         = 0;
+    double                                mLastX         = std::numeric_limits<double>::quiet_NaN();
+    double                                mStep          = std::numeric_limits<double>::quiet_NaN();
+    bool                                  mEvenlySpacedX = true; // every x step of the held samples alike
+};
+
+/// One streamed series of any element type SeriesMatrix_t holds
+typedef std::variant<RingBuffer_t<double>,
+                     RingBuffer_t<float>,
+                     RingBuffer_t<int8_t>,
+                     RingBuffer_t<uint8_t>,
+                     RingBuffer_t<int16_t>,
+                     RingBuffer_t<uint16_t>,
+                     RingBuffer_t<int32_t>,
+                     RingBuffer_t<uint32_t>,
+                     RingBuffer_t<ImS64>,
+                     RingBuffer_t<ImU64>>
+    SeriesRing_t;
+
+/// Buckets picked from a MinMaxPyramid_t to draw: two samples per bucket, each
+/// stored as its distance from the first sample of the bucket
+struct LevelOfDetail_t
+{
+    std::span<const uint32_t> offsets;
+    size_t                    first = 0; // bucket of offsets[0]
+    size_t                    shift = 0; // buckets of 2^shift samples
+
+    size_t size() const
+    {
+        return offsets.size();
+    }
+
+    bool empty() const
+    {
+        return offsets.empty();
+    }
+
+    /// Index of the sample in the series
+    size_t operator[](size_t index) const
+    {
+        return ((first + index / 2) << shift) + offsets[index];
+    }
+};
+
+/// Min/max summary of one series for drawing more samples than there are
+/// pixels. Level k splits the samples into buckets of 2^(k + FIRST_LEVEL) and
+/// keeps where in each bucket its lowest and highest y are, in sample order,
+/// so a line through them covers the same pixels as the full series. Each
+/// level is built from the one below, O(n) in total. The finest level has a
+/// bucket per 64 samples, so all levels take a quarter byte per sample; views
+/// zoomed in further are bucketed from the samples in view when drawn.
+struct MinMaxPyramid_t
+{
+    static constexpr size_t FIRST_LEVEL = 6;    // smallest stored bucket, 64 samples
+    static constexpr size_t MAX_SHIFT   = 32;   // largest bucket whose offsets fit in 32 bits
+    static constexpr size_t MIN_SAMPLES = 4096; // below this the full series is cheap enough
+
+    std::vector<std::vector<uint32_t>> levels;
+
+    template <class T>
+    void build(std::span<const T> y)
+    {
+        levels.clear();
+        if (y.size() < MIN_SAMPLES)
+        {
+            return;
+        }
+
+        // a NaN sample is only kept when the whole bucket is NaN
+        auto lower = [&y](size_t a, size_t b) { return std::isnan(y[a]) || y[b] < y[a] ? b : a; };
+        auto upper = [&y](size_t a, size_t b) { return std::isnan(y[a]) || y[b] > y[a] ? b : a; };
+
+        // first level straight from the samples
+        levels.emplace_back();
+        levels.back().reserve(2 * ((y.size() >> FIRST_LEVEL) + 1));
+        for (size_t first = 0; first < y.size(); first += size_t(1) << FIRST_LEVEL)
         {
-            std::sort(internalVector.begin(), internalVector.end());
-            std::vector<double>::iterator it;
-            it = std::unique(internalVector.begin(), internalVector.end());
-            internalVector.resize(std::distance(internalVector.begin(), it));
+            const size_t last = std::min(first + (size_t(1) << FIRST_LEVEL), y.size());
+            size_t       lo   = first;
+            size_t       hi   = first;
+            for (size_t index = first + 1; index < last; index++)
+            {
+                lo = lower(lo, index);
+                hi = upper(hi, index);
+            }
+            store(levels.back(), first, lo, hi);
+        }
 
-            min = internalVector.at(0);
-            max = internalVector.at(internalVector.size() - 1);
+        // then pairs of buckets until one is left
+        while (levels.back().size() > 2 && FIRST_LEVEL + levels.size() <= MAX_SHIFT)
+        {
+            const auto&           below = levels.back();
+            const size_t          shift = FIRST_LEVEL + levels.size() - 1;
+            std::vector<uint32_t> level;
+            level.reserve(below.size() / 2 + 2);
+            for (size_t index = 0; index < below.size(); index += 4)
+            {
+                const size_t first = (index / 2) << shift;
+                size_t       lo    = lower(first + below[index], first + below[index + 1]);
+                size_t       hi    = upper(first + below[index], first + below[index + 1]);
+                if (index + 2 < below.size())
+                {
+                    const size_t next = first + (size_t(1) << shift);
+                    lo                = lower(lower(lo, next + below[index + 2]), next + below[index + 3]);
+                    hi                = upper(upper(hi, next + below[index + 2]), next + below[index + 3]);
+                }
+                store(level, first, lo, hi);
+            }
+            levels.push_back(std::move(level));
         }
     }
 
     /// <summary>
-    /// Process the plot data
+    /// Buckets covering samples [first, last) of y from the finest level with at most maxBuckets of them.
+    /// Views finer than the first level are bucketed from y into a buffer of this thread, valid until the
+    /// next call; it keeps its capacity, so drawing allocates nothing once warm.
     /// </summary>
-    /// <param name="info">Matlab's info</param>
-    void processPlots(std::vector<ImPlot::MatlabInput_t>& info);
+    /// <returns>Empty if the samples already fit</returns>
+    template <class T>
+    LevelOfDetail_t select(std::span<const T> y, size_t first, size_t last, size_t maxBuckets) const
+    {
+        if (last - first <= maxBuckets || levels.empty())
+        {
+            return {};
+        }
+
+        const size_t stored = (((last - 1) >> FIRST_LEVEL) + 1) - (first >> FIRST_LEVEL);
+        if (2 * stored > maxBuckets)
+        {
+            for (size_t level = 0; level < levels.size(); level++)
+            {
+                const size_t shift = level + FIRST_LEVEL;
+                const size_t begin = first >> shift;
+                const size_t end   = ((last - 1) >> shift) + 1;
+                if (end - begin <= maxBuckets || level + 1 == levels.size())
+                {
+                    const auto offsets = std::span<const uint32_t>(levels[level]).subspan(2 * begin, 2 * (end - begin));
+                    return {offsets, begin, shift};
+                }
+            }
+        }
+
+        // half the pixels or fewer would get a bucket of the first level, smaller buckets fit
+        size_t shift = 1;
+        while ((((last - 1) >> shift) + 1) - (first >> shift) > maxBuckets)
+        {
+            shift++;
+        }
+        auto lower = [&y](size_t a, size_t b) { return std::isnan(y[a]) || y[b] < y[a] ? b : a; };
+        auto upper = [&y](size_t a, size_t b) { return std::isnan(y[a]) || y[b] > y[a] ? b : a; };
+
+        static thread_local std::vector<uint32_t> buckets;
+        buckets.clear();
+        const size_t begin = first >> shift;
+        const size_t end   = ((last - 1) >> shift) + 1;
+        for (size_t bucket = begin; bucket < end; bucket++)
+        {
+            const size_t start = std::max(bucket << shift, first);
+            const size_t stop  = std::min((bucket + 1) << shift, last);
+            size_t       lo    = start;
+            size_t       hi    = start;
+            for (size_t index = start + 1; index < stop; index++)
+            {
+                lo = lower(lo, index);
+                hi = upper(hi, index);
+            }
+            store(buckets, bucket << shift, lo, hi);
+        }
+        return {buckets, begin, shift};
+    }
+
+  private:
+    /// Lowest and highest sample of the bucket starting at first, in sample order
+    static void store(std::vector<uint32_t>& level, size_t first, size_t lo, size_t hi)
+    {
+        level.push_back(static_cast<uint32_t>(std::min(lo, hi) - first));
+        level.push_back(static_cast<uint32_t>(std::max(lo, hi) - first));
+    }
+};
+
+/// Everything needed to draw one series, resolved from the optional fields
+/// once at ingest so the frame loop does no lookups or string compares. The
+/// spans point into the sample buffers of the PlotData_t the command was
+/// compiled from.
+struct DrawCommand_t
+{
+    PlotType_e             type       = PlotType_e::LINE;
+    Decimation_e           decimation = Decimation_e::MINMAX;
+    std::string            legend;
+    bool                   colorAvailable     = false;
+    ImVec4                 color              = {};
+    bool                   markerAvailable    = false;
+    ImPlotMarker_          marker             = ImPlotMarker_None;
+    bool                   lineWidthAvailable = false;
+    float                  lineWidth          = 1.0f;
+    float                  markerSize         = 1.0f;
+    bool                   monotonicX         = false;
+    bool                   shaded             = false; // both uncertainty bounds given
+    const MinMaxPyramid_t* pyramid            = NULL;  // set for MINMAX decimation only
+
+    XData_t                 x;
+    SeriesSpan_t            y;
+    std::span<const double> lower;
+    std::span<const double> upper;
+
+    /// Number of samples
+    size_t size() const
+    {
+        return std::visit([](const auto& series) { return series.size(); }, y);
+    }
+};
+
+/// Plot infomations
+struct PlotData_t
+{
+    ColumnMatrix_t<double>     data1;
+    SeriesMatrix_t             data2;
+    std::vector<std::string>   plotTypes;
+    std::vector<ImPlotMarker_> markerShapes;
+    std::vector<ImVec4>        colors;
+    std::vector<double>        lineWidth;
+    std::vector<double>        markerSize;
+    std::vector<std::string>   title;
+    std::vector<std::string>   labels;
+    std::vector<std::string>   legends;
+    std::vector<double>        limits;
+    ColumnMatrix_t<double>     uncertaintyLowerBound;
+    ColumnMatrix_t<double>     uncertaintyUpperBound;
+    std::vector<double>        capacity;   // samples kept per series by "append"
+    std::vector<std::string>   decimation; // per series, one of getAvailableDecimations()
+    std::vector<double>        sampleRate; // samples per unit of implicit x
+    std::vector<double>        startTime;  // implicit x of the first sample
+
+    /// One pyramid per data2 series, shared by copies like the sample buffers
+    std::shared_ptr<const std::vector<MinMaxPyramid_t>> levelsOfDetail;
+
+    /// Per data1 series, x never decreases and holds no NaN, so the visible samples can be binary searched
+    std::vector<bool> monotonicX;
+
+    /// Per data1 series, x increases by one step throughout, so buckets of samples are buckets of x and the
+    /// min/max pyramid draws what the full series would
+    std::vector<bool> evenlySpacedX;
+
+    /// One per series, compiled by MatlabImGuiPlot::prepare
+    std::shared_ptr<const std::vector<DrawCommand_t>> commands;
+
+    PlotInfo_t plotInfo;
+
+    /// Recheck monotonicX and evenlySpacedX, needed whenever data1 changes
+    void updateMonotonicX()
+    {
+        monotonicX.assign(data1.size(), false);
+        evenlySpacedX.assign(data1.size(), false);
+        for (size_t index = 0; index < data1.size(); index++)
+        {
+            // series sharing a column (broadcast or deduplicated x) are checked once
+            const auto shared = std::find(data1.offsets.begin(), data1.offsets.begin() + index, data1.offsets[index]);
+            if (shared != data1.offsets.begin() + index)
+            {
+                monotonicX[index]    = monotonicX[shared - data1.offsets.begin()];
+                evenlySpacedX[index] = evenlySpacedX[shared - data1.offsets.begin()];
+                continue;
+            }
+
+            const auto x         = data1[index];
+            bool       monotonic = x.empty() || !std::isnan(x[0]);
+            for (size_t sample = 1; monotonic && sample < x.size(); sample++)
+            {
+                monotonic = x[sample] >= x[sample - 1];
+            }
+            monotonicX[index]    = monotonic;
+            evenlySpacedX[index] = monotonic && isEvenlySpaced(x);
+        }
+    }
+
+    /// <summary>
+    /// x of implicit-x series: 1..N as MATLAB's plot(y) numbers them, or
+    /// StartTime + i / SampleRate for fixed-rate signals
+    /// </summary>
+    XData_t getImplicitX() const
+    {
+        XData_t x;
+        if (plotInfo.sampleRateAvailable)
+        {
+            x.start = 0.0;
+            x.scale = 1.0 / sampleRate[0];
+        }
+        if (plotInfo.startTimeAvailable)
+        {
+            x.start = startTime[0];
+        }
+        return x;
+    }
+
+    /// Range of x over all series, generated x is known without looking at samples
+    Bounds_t getXBounds() const
+    {
+        if (!plotInfo.implicitX)
+        {
+            return data1.totalBounds;
+        }
+        const XData_t x = getImplicitX();
+        return data2.rows() > 0 ? Bounds_t{x[0], x[data2.rows() - 1]} : Bounds_t{};
+    }
+
+    /// Rebuild the pyramids, needed whenever data2 changes
+    void updateLevelsOfDetail()
+    {
+        auto pyramids = std::make_shared<std::vector<MinMaxPyramid_t>>(data2.size());
+        data2.visit(
+            [&pyramids](const auto& columns)
+            {
+                for (size_t index = 0; index < columns.size(); index++)
+                {
+                    (*pyramids)[index].build(columns[index]);
+                }
+            });
+        levelsOfDetail = std::move(pyramids);
+    }
+
+    const ColumnMatrix_t<double>& getData1() const
+    {
+        return data1;
+    }
+    const SeriesMatrix_t& getData2() const
+    {
+        return data2;
+    }
+    const std::vector<std::string>& getPlotTypes() const
+    {
+        return plotTypes;
+    }
+    const std::vector<ImPlotMarker_>& getMarkerShapes() const
+    {
+        return markerShapes;
+    }
+    const std::vector<ImVec4>& getColors() const
+    {
+        return colors;
+    }
+    const std::vector<double>& getLineWidth() const
+    {
+        return lineWidth;
+    }
+    const std::vector<double>& getMarkerSize() const
+    {
+        return markerSize;
+    }
+    const std::vector<std::string>& getTitle() const
+    {
+        return title;
+    }
+    const std::vector<std::string>& getLabels() const
+    {
+        return labels;
+    }
+    const std::vector<std::string>& getLegends() const
+    {
+        return legends;
+    }
+    const std::vector<double>& getLimits() const
+    {
+        return limits;
+    }
+    const ColumnMatrix_t<double>& getUncertaintyLowerBound() const
+    {
+        return uncertaintyLowerBound;
+    }
+    const ColumnMatrix_t<double>& getUncertaintyUpperBound() const
+    {
+        return uncertaintyUpperBound;
+    }
+    const std::vector<double>& getCapacity() const
+    {
+        return capacity;
+    }
+    const std::vector<std::string>& getDecimation() const
+    {
+        return decimation;
+    }
+    const std::vector<double>& getSampleRate() const
+    {
+        return sampleRate;
+    }
+    const std::vector<double>& getStartTime() const
+    {
+        return startTime;
+    }
+    const std::vector<DrawCommand_t>& getDrawCommands() const
+    {
+        static const std::vector<DrawCommand_t> none;
+        return commands ? *commands : none;
+    }
+    const std::vector<bool>& getMonotonicX() const
+    {
+        return monotonicX;
+    }
+    const std::vector<bool>& getEvenlySpacedX() const
+    {
+        return evenlySpacedX;
+    }
+    const std::vector<MinMaxPyramid_t>* getLevelsOfDetail() const
+    {
+        return levelsOfDetail.get();
+    }
+
+    const PlotInfo_t& getPlotInfo() const
+    {
+        return plotInfo;
+    }
+};
+
+/// Sample fields of one subplot as viewed in MATLAB's buffers, copied into its PlotData_t off the MEX thread
+struct SampleViews_t
+{
+    MatrixView_t data1;
+    MatrixView_t data2;
+    MatrixView_t uncertaintyLowerBound;
+    MatrixView_t uncertaintyUpperBound;
+
+    /// Bytes viewed, all of which copyTo reads
+    size_t bytes() const
+    {
+        return data1.bytes + data2.bytes + uncertaintyLowerBound.bytes + uncertaintyUpperBound.bytes;
+    }
+
+    /// <summary>
+    /// Copy the fields data.plotInfo says are given. A lone data1 is y with implicit x, x is otherwise stored as
+    /// double, once per distinct column.
+    /// </summary>
+    void copyTo(PlotData_t& data) const
+    {
+        auto& plotInfo = data.plotInfo;
+        if (plotInfo.uncertaintyLowerBoundAvailable)
+        {
+            data.uncertaintyLowerBound = uncertaintyLowerBound.toMatrix().toDouble();
+        }
+        if (plotInfo.uncertaintyUpperBoundAvailable)
+        {
+            data.uncertaintyUpperBound = uncertaintyUpperBound.toMatrix().toDouble();
+        }
+        if (plotInfo.data2Available)
+        {
+            data.data2 = data2.toMatrix();
+        }
+
+        // Only 1D data is available so it is y, x is generated from the sample index when drawn
+        if (plotInfo.data1Available && !plotInfo.data2Available)
+        {
+            data.data2         = data1.toMatrix();
+            plotInfo.implicitX = true;
+        }
+        else if (plotInfo.data1Available)
+        {
+            // each matrix was split by its own columns; one time base is usually shared by every series, it is
+            // stored once
+            data.data1 = data1.toMatrix().toDouble();
+            data.data1.broadcast(data.data2.size());
+            data.data1.shareIdenticalColumns();
+        }
+    }
+};
+
+struct MatlabInput_t
+{
+    std::string             figureConfig;
+    std::vector<double>     subModuleDimensions;
+    std::vector<PlotData_t> plotData;
+    std::string             windowTitle; // figure name plus a unique ImGui id
+    uint64_t                handle = 0;
+    FrameRate_t             frameRate;
+
+    const std::string& getMatlabFigureNames() const
+    {
+        return figureConfig;
+    }
+
+    const std::string& getWindowTitle() const
+    {
+        return windowTitle;
+    }
+
+    const std::vector<double>& getSubModuleDimensions() const
+    {
+        return subModuleDimensions;
+    }
+
+    const std::vector<PlotData_t>& getMatlabPlotData() const
+    {
+        return plotData;
+    }
+};
+
+/// A figure to draw offscreen and the PNG file to write it to
+struct ExportJob_t
+{
+    MatlabInput_t figure;
+    std::string   fileName;
+    int           width  = 1280;
+    int           height = 720;
+};
+
+/// Samples for subplot "subplot" (zero based) of figure "handle", one column per series
+struct AppendPacket_t
+{
+    uint64_t               handle  = 0;
+    size_t                 subplot = 0;
+    ColumnMatrix_t<double> data1;
+    SeriesMatrix_t         data2;
+    bool                   implicitX = false; // no data1, x continues from the samples already seen
+};
+
+/// Samples picked by a MinMaxPyramid_t level, drawn through ImPlot's getter API
+template <class T>
+struct LevelOfDetailView_t
+{
+    XData_t         x;
+    const T*        y;
+    LevelOfDetail_t buckets;
+};
+
+/// Samples of a ring picked by RingBuffer_t::select, drawn through ImPlot's getter API
+template <class T>
+struct RingSamplesView_t
+{
+    const double*           x;
+    const T*                y;
+    std::span<const size_t> samples;
+};
+
+/// Series ImPlot's typed overloads cannot take: y of another type than stored x, or bars of scaled implicit x
+template <class T>
+struct SeriesView_t
+{
+    XData_t  x;
+    const T* y;
+    int      count;
+    int      offset;
+};
+
+/// LTTB result of one series for the visible range, computed off the render thread
+struct DecimationCache_t
+{
+    std::shared_ptr<const void> source; // data2 buffer the results are for
+    double                      xMin      = 0.0;
+    double                      xMax      = 0.0;
+    size_t                      threshold = 0; // request of the latest job
+
+    std::shared_ptr<const DecimatedSeries_t>              ready;
+    std::future<std::shared_ptr<const DecimatedSeries_t>> pending;
+};
+
+/// Ring buffers of a subplot created with a Capacity, owned by the render thread
+struct StreamData_t
+{
+    std::shared_ptr<const void> source; // data2 buffer the rings were seeded from
+    std::vector<SeriesRing_t>   series;
+    size_t                      capacity = 0;
+    XData_t                     implicitX; // x of samples appended without data1
+    Bounds_t                    xBounds;
+    Bounds_t                    yBounds;
+
+    void updateBounds()
+    {
+        xBounds = {};
+        yBounds = {};
+        for (const auto& ring : series)
+        {
+            std::visit(
+                [this](const auto& typed)
+                {
+                    xBounds.merge(typed.xBounds());
+                    yBounds.merge(typed.yBounds());
+                },
+                ring);
+        }
+    }
+};
+
+} // namespace ImPlot
+
+class MatlabImGuiPlot
+{
+  public:
+    MatlabImGuiPlot() = default;
+    ~MatlabImGuiPlot();
+
+    /// <summary>
+    /// Hand the figures to the render thread, which is started on first use.
+    /// Returns as soon as the data is published; the window stays up while the caller runs on.
+    /// </summary>
+    /// <param name="data">Figures replacing the ones on display, already checked by errorCheck</param>
+    void show(std::vector<ImPlot::MatlabInput_t> data);
+
+    /// <summary>
+    /// Queue samples for a subplot created with a Capacity. Only the new samples are copied,
+    /// the render thread pushes them into the subplot's ring buffers.
+    /// </summary>
+    /// <param name="packet">Samples for a figure already passed to show</param>
+    void append(ImPlot::AppendPacket_t packet);
+
+    /// <summary>
+    /// Draw figures offscreen, each filling an image of its size, and write them to PNG files. Started
+    /// by the render thread between frames and drawn by export workers with contexts of their own, so
+    /// the window is never shown. Figures that were passed to show are drawn with their streamed
+    /// samples. Blocks until every file is written.
+    /// Throws std::runtime_error for the first figure that could not be drawn or written.
+    /// </summary>
+    void exportFigures(std::vector<ImPlot::ExportJob_t> jobs);
+
+    /// <summary>
+    /// Frame times of the render thread, safe to call while it runs
+    /// </summary>
+    ImPlot::FrameStats_t getFrameStats() const
+    {
+        return mPacer.getStats();
+    }
+
+    /// <summary>
+    /// Process the plot data: submit the figures to the current ImGui frame, between ImGui::NewFrame and
+    /// ImGui::Render. Called by the render thread and the export workers, and by the benchmarks in Test
+    /// on a context of their own.
+    /// </summary>
+    /// <param name="info">Matlab's info</param>
+    /// <param name="offscreen">Figures fill the display without decorations, their axes are fitted every
+    /// frame and LTTB is not waited for</param>
+    void processPlots(const std::vector<ImPlot::MatlabInput_t>& info, bool offscreen = false);
+
+    /// <summary>
+    /// Plotting data errors check, throws std::invalid_argument
+    /// </summary>
+    static void errorCheck(const ImPlot::PlotData_t& data);
+
+    /// <summary>
+    /// Check the data, then build what the renderer needs from it: the monotonic x flags and
+    /// LOD pyramids for sample buffers that changed, and the draw commands. Throws std::invalid_argument.
+    /// </summary>
+    /// <param name="previous">Data this replaces, its flags and pyramids are kept for unchanged buffers</param>
+    static void prepare(ImPlot::PlotData_t& data, const ImPlot::PlotData_t* previous = NULL);
+
+    /// Optional struct fields, in Miscellaneous_e order
+    static constexpr std::array<std::string_view, ImPlot::Miscellaneous_e::START_TIME + 1> INPUT_VARIABLE_NAMES = {
+        "PlotTypes",
+        "MarkerShapes",
+        "Colors",
+        "LineWidths",
+        "MarkerSizes",
+        "Title",
+        "Labels",
+        "Legends",
+        "Limits",
+        "UncertaintyLowerBound",
+        "UncertaintyUpperBound",
+        "Capacity",
+        "Decimation",
+        "SampleRate",
+        "StartTime",
+    };
+
+    static constexpr std::span<const std::string_view> getAvailableInputVariableNames()
+    {
+        return INPUT_VARIABLE_NAMES;
+    }
+
+    static std::vector<std::string> getAvailableDecimations()
+    {
+        return {
+            "none",
+            "minmax",
+            "lttb",
+        };
+    }
+
+    static std::vector<std::string> getAvailablePlotTypes()
+    {
+        return {
+            "Line",
+            "Scatter",
+            "Bars",
+        };
+    }
+
+    /// Named colors, looked up through ImPlot::findColor
+    static constexpr std::span<const ImPlot::NamedColor_t> getAvailableColorTypes()
+    {
+        return ImPlot::COLOR_TABLE;
+    }
+
+    /// Marker symbols and names, looked up through ImPlot::findMarker
+    static constexpr std::span<const ImPlot::NamedMarker_t> getAvailableMarkerInfo()
+    {
+        return ImPlot::MARKER_TABLE;
+    }
+
+  private:
+    /// Figures handed from the MEX thread to the render thread
+    ImPlot::LockFreeDoubleBuffer_t<std::vector<ImPlot::MatlabInput_t>> mFigures;
+
+    /// Appended samples, handed over in order
+    ImPlot::LockFreeQueue_t<ImPlot::AppendPacket_t, 256> mAppends;
+
+    std::thread       mRenderThread;
+    std::atomic<bool> mRunning = false;
+
+    /// Ring buffers by figure handle and subplot, render thread only
+    std::map<std::pair<uint64_t, size_t>, ImPlot::StreamData_t> mStreams;
+
+    /// LTTB results by figure handle, subplot and series, render thread only
+    std::map<std::array<uint64_t, 3>, ImPlot::DecimationCache_t> mDecimations;
+
+    /// Workers for decimation, started on first use
+    std::unique_ptr<ImPlot::ThreadPool_t> mWorkers;
+
+    /// Frames each figure still needs drawing for, by handle, render thread only. The window is only
+    /// redrawn while one of them is left, otherwise the render thread sleeps in glfwWaitEventsTimeout.
+    std::map<uint64_t, int> mDirtyFrames;
+
+    /// ImGui settles hover state and layout a frame after the change, and ImPlot fits its axes over
+    /// its first frames, so a change is drawn for a few frames
+    static constexpr int REDRAW_FRAMES = 3;
+
+    /// Longest sleep of an idle render thread, a safety net in case a wake-up is missed
+    static constexpr double IDLE_TIMEOUT_SECONDS = 0.5;
+
+    /// Figures to export, handed from the MEX thread to the render thread
+    struct ExportRequest_t
+    {
+        std::vector<ImPlot::ExportJob_t> jobs;
+        std::promise<void>               done;
+    };
+    std::mutex                  mExportMutex;
+    std::deque<ExportRequest_t> mExportRequests;
+
+    /// Export workers, each drawing with its own offscreen context, and the PNG encoders they hand
+    /// images to; started on first use
+    std::unique_ptr<ImPlot::ThreadPool_t> mExportWorkers;
+    std::unique_ptr<ImPlot::ThreadPool_t> mEncoders;
+
+    /// ImGui and ImPlot keep their current context in globals, so export workers build frames one at a time
+    std::mutex mFrameMutex;
+
+    /// Frame building is serialized, so more contexts than this only cost memory
+    static constexpr size_t MAX_EXPORT_CONTEXTS = 4;
+
+    /// Images waiting for an encoder per encoder thread, beyond which workers wait instead of piling up pixels
+    static constexpr size_t PENDING_IMAGES_PER_ENCODER = 2;
+
+    /// ImGui sizes the window and ImPlot lays out and fits the subplots over the first frames,
+    /// so only the last of these is written
+    static constexpr int EXPORT_FRAMES = 3;
+
+    /// <summary>
+    /// Start the render thread if it is not running
+    /// </summary>
+    void start();
+
+    /// <summary>
+    /// Draw and write the figures of every queued export request
+    /// </summary>
+    /// <returns>Whether any was queued</returns>
+    bool processExports();
+
+    /// <summary>
+    /// Draw and write a list of figures. Workers with their own contexts draw them in parallel and
+    /// hand the pixels to the encoders. Throws std::runtime_error for the first figure that failed.
+    /// </summary>
+    void exportBatch(const std::vector<ImPlot::ExportJob_t>& jobs);
+
+    /// <summary>
+    /// Draw one figure into the framebuffer of a context current on this thread, throws std::runtime_error
+    /// </summary>
+    /// <returns>RGBA pixels, top row first</returns>
+    std::vector<unsigned char> renderOffscreen(ImPlot::OffscreenContext_t& context, const ImPlot::ExportJob_t& job);
+
+    /// Frame pacing to the fastest rate of the figures being drawn
+    ImPlot::FramePacer_t mPacer;
+    int                  mSwapInterval = 1; // as set up by ImGuiContextManager
+
+    /// Figure whose ImGui window had focus in the last frame, 0 for none; render thread only
+    uint64_t mFocusedFigure = 0;
+
+    /// <summary>
+    /// Fastest frame rate of the dirty figures, each at its focused rate if it has focus
+    /// </summary>
+    /// <param name="windowFocused">Whether the GLFW window has focus</param>
+    /// <param name="refreshRate">Rate of the monitor, which vsync is compared at</param>
+    double getFrameRate(bool windowFocused, double refreshRate) const;
+
+    /// <summary>
+    /// Draw a figure for the next REDRAW_FRAMES frames
+    /// </summary>
+    void markDirty(uint64_t handle);
+
+    /// <summary>
+    /// Draw every figure on display for the next REDRAW_FRAMES frames, dropping closed ones
+    /// </summary>
+    void markAllDirty();
+
+    /// <summary>
+    /// Whether any figure needs drawing, counting one frame off each that does
+    /// </summary>
+    bool takeDirtyFrame();
+
+    /// <summary>
+    /// Push queued samples into the ring buffers
+    /// </summary>
+    /// <param name="figuresChanged">Set if newer figures had to be taken to find a subplot</param>
+    void consumeAppends(bool& figuresChanged);
+
+    /// <summary>
+    /// LTTB samples of a series for the current plot limits. A job is queued whenever the limits
+    /// or plot width change; until it finishes the previous result is returned.
+    /// </summary>
+    /// <returns>NULL until the first job for this series is done</returns>
+    const ImPlot::DecimatedSeries_t* decimate(uint64_t handle, size_t subplot, size_t index,
+                                              const ImPlot::PlotData_t& data);
+
+    /// <summary>
+    /// Ring buffers of a subplot, NULL if it is not streamed
+    /// </summary>
+    const ImPlot::StreamData_t* findStream(uint64_t handle, size_t subplot) const;
+
+    /// <summary>
+    /// Keep render thread state in step with the published figures: new Capacity subplots are
+    /// seeded with their data, replaced data re-seeds them and drops its LTTB results, and
+    /// closed figures drop both
+    /// </summary>
+    void syncFigures();
+
+    /// <summary>
+    /// Long-lived render thread: owns the window and draws the latest published figures
+    /// </summary>
+    void renderLoop();
+
+    /// <summary>
+    /// Number of samples handed to ImPlot, which counts with int
+    /// </summary>
+    static int getPlotCount(size_t numElements)
+    {
+        return static_cast<int>(std::min(numElements, static_cast<size_t>(INT_MAX)));
+    }
+
+    /// <summary>
+    /// Line plot of a series, through the coarsest pyramid level that still
+    /// has a bucket for every pixel of the plot width. Implicit x is passed as
+    /// ImPlot's xscale/x0; stored x with y of another type than double is
+    /// drawn through a getter, as ImPlot takes x and y of one type.
+    /// </summary>
+    /// <param name="first">First of the numElements samples to draw, buckets of the pyramid count from sample 0</param>
+    /// <param name="pyramid">Min/max summary of y, NULL to draw every sample</param>
+    /// <param name="ringSamples">Samples of a ring picked by RingBuffer_t::select, drawn instead when given</param>
+    template <class T>
+    static void plotLine(const char*                    label,
+                         const ImPlot::XData_t&         xData,
+                         const T*                       yData,
+                         int                            first,
+                         int                            numElements,
+                         int                            offset,
+                         const ImPlot::MinMaxPyramid_t* pyramid,
+                         std::span<const size_t>        ringSamples);
+
+    /// <summary>
+    /// Scatter plot of a series, as plotLine when "minmax" decimation is asked for
+    /// </summary>
+    template <class T>
+    static void plotScatter(const char*                    label,
+                            const ImPlot::XData_t&         xData,
+                            const T*                       yData,
+                            int                            first,
+                            int                            numElements,
+                            int                            offset,
+                            const ImPlot::MinMaxPyramid_t* pyramid,
+                            std::span<const size_t>        ringSamples);
+
+    /// <summary>
+    /// Samples of a monotonic x series inside range, plus one on either side so lines reach the plot edge.
+    /// Stored x is binary searched, generated x is solved for.
+    /// </summary>
+    /// <returns>First sample and number of samples</returns>
+    static std::pair<size_t, size_t> getVisibleRange(const ImPlot::XData_t& x,
+                                                     size_t                 numElements,
+                                                     const ImPlotRange&     range);
+
+    /// <summary>
+    /// Bar plot of a series, bars of implicit x are barSize samples wide
+    /// </summary>
+    template <class T>
+    static void plotBars(const char*            label,
+                         const ImPlot::XData_t& xData,
+                         const T*               yData,
+                         int                    first,
+                         int                    numElements,
+                         int                    offset,
+                         double                 barSize);
+
+    template <class T>
+    static ImPlotPoint getLevelOfDetailPoint(int index, void* data);
+
+    template <class T>
+    static ImPlotPoint getRingSamplesPoint(int index, void* data);
+
+    template <class T>
+    static ImPlotPoint getSeriesPoint(int index, void* data);
 };
@@ -0,0 +1,54 @@
+#pragma once
+
+/// STL headers
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+
+namespace ImPlot
+{
+/// Framebuffer object frames are drawn into instead of the window, for writing figures to image
+/// files without showing them. Needs the OpenGL context it was created with to be current.
+class OffscreenTarget_t
+{
+  public:
+    OffscreenTarget_t() = default;
+    ~OffscreenTarget_t();
+
+    OffscreenTarget_t(const OffscreenTarget_t&)            = delete;
+    OffscreenTarget_t& operator=(const OffscreenTarget_t&) = delete;
+
+    /// <summary>
+    /// Bind the framebuffer for drawing, creating or resizing it first if needed
+    /// </summary>
+    /// <returns>False if the driver cannot make a framebuffer of this size</returns>
+    bool bind(int width, int height);
+
+    /// <summary>
+    /// Draw to the window again
+    /// </summary>
+    void unbind();
+
+    /// <summary>
+    /// RGBA pixels of the bound framebuffer, top row first
+    /// </summary>
+    std::vector<unsigned char> readPixels() const;
+
+    /// <summary>
+    /// Delete the framebuffer; must run before its context is destroyed
+    /// </summary>
+    void release();
+
+    /// <summary>
+    /// Write RGBA pixels, top row first, to a PNG file
+    /// </summary>
+    /// <returns>False if the file cannot be written</returns>
+    static bool writePng(const std::string& fileName, int width, int height, const std::vector<unsigned char>& pixels);
+
+  private:
+    GLuint mFramebuffer = 0;
+    GLuint mColor       = 0;
+    int    mWidth       = 0;
+    int    mHeight      = 0;
+};
+} // namespace ImPlot
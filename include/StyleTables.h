@@ -0,0 +1,374 @@
+#pragma once
+
+/// STL headers
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "imgui.h"
+#include "implot.h"
+
+namespace ImPlot
+{
+struct NamedColor_t
+{
+    std::string_view name;
+    ImVec4           color;
+};
+
+struct NamedMarker_t
+{
+    std::string_view symbol;
+    std::string_view name;
+    ImPlotMarker_    marker;
+};
+
+/// Colors accepted by name in the Colors field
+inline constexpr auto COLOR_TABLE = std::to_array<NamedColor_t>({
+    NamedColor_t{"Background", ImVec4(0.800f, 0.800f, 0.800f, 1.00f)},
+    NamedColor_t{"LightGray", ImVec4(0.800f, 0.800f, 0.800f, 1.00f)},
+    NamedColor_t{"Gray", ImVec4(0.502f, 0.502f, 0.502f, 1.00f)},
+    NamedColor_t{"Indigo", ImVec4(0.294f, 0.000f, 0.510f, 1.00f)},
+    NamedColor_t{"BlueViolet", ImVec4(0.541f, 0.169f, 0.886f, 1.00f)},
+    NamedColor_t{"DarkestBlue", ImVec4(0.000f, 0.000f, 0.500f, 1.00f)},
+    NamedColor_t{"DarkBlue", ImVec4(0.000f, 0.000f, 0.750f, 1.00f)},
+    NamedColor_t{"Blue", ImVec4(0.000f, 0.000f, 1.000f, 1.00f)},
+    NamedColor_t{"LightBlue", ImVec4(0.350f, 0.350f, 1.000f, 1.00f)},
+    NamedColor_t{"DodgerBlue", ImVec4(0.118f, 0.565f, 1.000f, 1.00f)},
+    NamedColor_t{"Cyan", ImVec4(0.000f, 1.000f, 1.000f, 1.00f)},
+    NamedColor_t{"DarkCyan", ImVec4(0.000f, 0.600f, 0.600f, 1.00f)},
+    NamedColor_t{"Lime", ImVec4(0.000f, 1.000f, 0.000f, 1.00f)},
+    NamedColor_t{"Green", ImVec4(0.000f, 0.800f, 0.000f, 1.00f)},
+    NamedColor_t{"LightGreen", ImVec4(0.000f, 1.000f, 0.000f, 1.00f)},
+    NamedColor_t{"DarkGreen", ImVec4(0.000f, 0.600f, 0.000f, 1.00f)},
+    NamedColor_t{"Yellow", ImVec4(1.000f, 1.000f, 0.000f, 1.00f)},
+    NamedColor_t{"DarkYellow", ImVec4(0.700f, 0.700f, 0.000f, 1.00f)},
+    NamedColor_t{"Orange", ImVec4(1.000f, 0.647f, 0.000f, 1.00f)},
+    NamedColor_t{"Red", ImVec4(1.000f, 0.000f, 0.000f, 1.00f)},
+    NamedColor_t{"DarkRed", ImVec4(0.700f, 0.000f, 0.000f, 1.00f)},
+    NamedColor_t{"Brown", ImVec4(0.545f, 0.000f, 0.000f, 1.00f)},
+    NamedColor_t{"Magenta", ImVec4(1.000f, 0.000f, 1.000f, 1.00f)},
+    NamedColor_t{"DarkMagenta", ImVec4(0.600f, 0.000f, 0.600f, 1.00f)},
+    NamedColor_t{"Black", ImVec4(0.000f, 0.000f, 0.000f, 1.00f)},
+    NamedColor_t{"White", ImVec4(1.000f, 1.000f, 1.000f, 1.00f)},
+    NamedColor_t{"IndianRed", ImVec4(0.80F, 0.36F, 0.36F, 1.00f)},
+    NamedColor_t{"MediumVioletRed", ImVec4(0.7804F, 0.0824F, 0.5216F, 1.00f)},
+    NamedColor_t{"OrangeRed", ImVec4(1.0F, 0.27F, 0.0F, 1.00f)},
+    NamedColor_t{"VioletRed", ImVec4(0.97F, 0.33F, 0.58F, 1.00f)},
+    NamedColor_t{"DarkOliveGreen", ImVec4(0.33F, 0.42F, 0.18F, 1.00f)},
+    NamedColor_t{"ForestGreen", ImVec4(0.137255F, 0.556863F, 0.137255F, 1.00f)},
+    NamedColor_t{"GreenYellow", ImVec4(0.68F, 1.0F, 0.18F, 1.00f)},
+    NamedColor_t{"LimeGreen", ImVec4(0.196078F, 0.8F, 0.196078F, 1.00f)},
+    NamedColor_t{"OliveDrab", ImVec4(0.419608F, 0.556863F, 0.137255F, 1.00f)},
+    NamedColor_t{"MediumSeaGreen", ImVec4(0.24F, 0.7F, 0.44F, 1.00f)},
+    NamedColor_t{"MediumSpringGreen", ImVec4(0.0F, 0.98F, 0.6F, 1.00f)},
+    NamedColor_t{"PaleGreen", ImVec4(0.60F, 0.98F, 0.60F, 1.00f)},
+    NamedColor_t{"SeaGreen", ImVec4(0.18F, 0.55F, 0.34F, 1.00f)},
+    NamedColor_t{"SpringGreen", ImVec4(0.0F, 1.0F, 0.498039F, 1.00f)},
+    NamedColor_t{"YellowGreen", ImVec4(0.6F, 0.8F, 0.196078F, 1.00f)},
+    NamedColor_t{"GreenCopper", ImVec4(0.32F, 0.49F, 0.46F, 1.00f)},
+    NamedColor_t{"DarkGreenCopper", ImVec4(0.29F, 0.46F, 0.43F, 1.00f)},
+    NamedColor_t{"HuntersGreen", ImVec4(0.21F, 0.37F, 0.23F, 1.00f)},
+    NamedColor_t{"CadetBlue", ImVec4(0.372549F, 0.623529F, 0.623529F, 1.00f)},
+    NamedColor_t{"CornflowerBlue", ImVec4(0.39F, 0.58F, 0.93F, 1.00f)},
+    NamedColor_t{"DarkSlateBlue", ImVec4(0.28F, 0.24F, 0.55F, 1.00f)},
+    NamedColor_t{"LightSteelBlue", ImVec4(0.27F, 0.51F, 0.71F, 1.00f)},
+    NamedColor_t{"MediumBlue", ImVec4(0.0F, 0.0F, 0.8F, 1.00f)},
+    NamedColor_t{"MediumSlateBlue", ImVec4(0.48F, 0.41F, 0.93F, 1.00f)},
+    NamedColor_t{"MidnightBlue", ImVec4(0.10F, 0.10F, 0.44F, 1.00f)},
+    NamedColor_t{"NavyBlue", ImVec4(0.0F, 0.0F, 0.50F, 1.00f)},
+    NamedColor_t{"SkyBlue", ImVec4(0.53F, 0.81F, 0.92F, 1.00f)},
+    NamedColor_t{"SlateBlue", ImVec4(0.42F, 0.35F, 0.80F, 1.00f)},
+    NamedColor_t{"SteelBlue", ImVec4(0.27F, 0.51F, 0.71F, 1.00f)},
+    NamedColor_t{"RichBlue", ImVec4(0.35F, 0.35F, 0.67F, 1.00f)},
+    NamedColor_t{"NeonBlue", ImVec4(0.27F, 0.40F, 1.0F, 1.00f)},
+    NamedColor_t{"NewMidnightBlue", ImVec4(0.00F, 0.00F, 0.61F, 1.00f)},
+    NamedColor_t{"DimGray", ImVec4(0.41F, 0.41F, 0.41F, 1.00f)},
+    NamedColor_t{"VLightGray", ImVec4(0.83F, 0.83F, 0.83F, 1.00f)},
+    NamedColor_t{"DarkSlateGray", ImVec4(0.184314F, 0.309804F, 0.309804F, 1.00f)},
+    NamedColor_t{"MandarinOrange", ImVec4(0.96F, 0.60F, 0.02F, 1.00f)},
+    NamedColor_t{"Aquamarine", ImVec4(0.50F, 1.0F, 0.83F, 1.00f)},
+    NamedColor_t{"Coral", ImVec4(1.0F, 0.498039F, 0.31F, 1.00f)},
+    NamedColor_t{"DarkOrchid", ImVec4(0.6F, 0.196078F, 0.8F, 1.00f)},
+    NamedColor_t{"DarkTurquoise", ImVec4(0.0F, 0.81F, 0.82F, 1.00f)},
+    NamedColor_t{"Firebrick", ImVec4(0.70F, 0.13F, 0.13F, 1.00f)},
+    NamedColor_t{"Gold", ImVec4(1.0F, 0.84F, 0.0F, 1.00f)},
+    NamedColor_t{"Goldenrod", ImVec4(0.85F, 0.65F, 0.13F, 1.00f)},
+    NamedColor_t{"Khaki", ImVec4(0.94F, 0.90F, 0.55F, 1.00f)},
+    NamedColor_t{"Maroon", ImVec4(0.50F, 0.0F, 0.0F, 1.00f)},
+    NamedColor_t{"MediumAquamarine", ImVec4(0.4F, 0.8F, 0.67F, 1.00f)},
+    NamedColor_t{"MediumGoldenrod", ImVec4(0.917647F, 0.917647F, 0.678431F, 1.00f)},
+    NamedColor_t{"MediumOrchid", ImVec4(0.73F, 0.33F, 0.83F, 1.00f)},
+    NamedColor_t{"MediumTurquoise", ImVec4(0.28F, 0.82F, 0.80F, 1.00f)},
+    NamedColor_t{"Orchid", ImVec4(0.858824F, 0.439216F, 0.858824F, 1.00f)},
+    NamedColor_t{"Pink", ImVec4(1.0F, 0.75F, 0.80F, 1.00f)},
+    NamedColor_t{"Plum", ImVec4(0.87F, 0.63F, 0.87F, 1.00f)},
+    NamedColor_t{"Salmon", ImVec4(0.98F, 0.50F, 0.45F, 1.00f)},
+    NamedColor_t{"Sienna", ImVec4(0.63F, 0.32F, 0.18F, 1.00f)},
+    NamedColor_t{"Tan", ImVec4(0.82F, 0.71F, 0.55F, 1.00f)},
+    NamedColor_t{"Thistle", ImVec4(0.847059F, 0.74902F, 0.847059F, 1.00f)},
+    NamedColor_t{"Turquoise", ImVec4(0.25F, 0.88F, 0.82F, 1.00f)},
+    NamedColor_t{"Violet", ImVec4(0.93F, 0.51F, 0.93F, 1.00f)},
+    NamedColor_t{"Wheat", ImVec4(0.96F, 0.87F, 0.70F, 1.00f)},
+    NamedColor_t{"SummerSky", ImVec4(0.22F, 0.69F, 0.87F, 1.00f)},
+    NamedColor_t{"Brass", ImVec4(0.71F, 0.65F, 0.26F, 1.00f)},
+    NamedColor_t{"Copper", ImVec4(0.72F, 0.45F, 0.20F, 1.00f)},
+    NamedColor_t{"Bronze", ImVec4(0.8F, 0.5F, 0.2F, 1.00f)},
+    NamedColor_t{"Silver", ImVec4(0.75F, 0.75F, 0.75F, 1.00f)},
+    NamedColor_t{"BrightGold", ImVec4(0.82F, 0.63F, 0.29F, 1.00f)},
+    NamedColor_t{"OldGold", ImVec4(0.81F, 0.71F, 0.23F, 1.00f)},
+    NamedColor_t{"Feldspar", ImVec4(0.82F, 0.57F, 0.46F, 1.00f)},
+    NamedColor_t{"Quartz", ImVec4(0.32F, 0.28F, 0.31F, 1.00f)},
+    NamedColor_t{"NeonPink", ImVec4(1.00F, 0.43F, 0.78F, 1.00f)},
+    NamedColor_t{"DarkPurple", ImVec4(0.19F, 0.10F, 0.20F, 1.00f)},
+    NamedColor_t{"CoolCopper", ImVec4(0.85F, 0.53F, 0.10F, 1.00f)},
+    NamedColor_t{"LightWood", ImVec4(0.91F, 0.76F, 0.65F, 1.00f)},
+    NamedColor_t{"MediumWood", ImVec4(0.65F, 0.50F, 0.39F, 1.00f)},
+    NamedColor_t{"DarkWood", ImVec4(0.52F, 0.37F, 0.26F, 1.00f)},
+    NamedColor_t{"SpicyPink", ImVec4(1.00F, 0.11F, 0.68F, 1.00f)},
+    NamedColor_t{"SemiSweetChocolate", ImVec4(0.42F, 0.26F, 0.15F, 1.00f)},
+    NamedColor_t{"BakersChocolate", ImVec4(0.36F, 0.20F, 0.09F, 1.00f)},
+    NamedColor_t{"Flesh", ImVec4(0.96F, 0.80F, 0.69F, 1.00f)},
+    NamedColor_t{"NewTan", ImVec4(0.92F, 0.78F, 0.62F, 1.00f)},
+    NamedColor_t{"VeryDarkBrown", ImVec4(0.35F, 0.16F, 0.14F, 1.00f)},
+    NamedColor_t{"DarkBrown", ImVec4(0.36F, 0.25F, 0.20F, 1.00f)},
+    NamedColor_t{"DarkTan", ImVec4(0.59F, 0.41F, 0.31F, 1.00f)},
+    NamedColor_t{"DustyRose", ImVec4(0.52F, 0.39F, 0.39F, 1.00f)},
+    NamedColor_t{"Scarlet", ImVec4(1.0F, 0.14F, 0.0F, 1.00f)},
+    NamedColor_t{"MediumPurple", ImVec4(0.58F, 0.44F, 0.86F, 1.00f)},
+    NamedColor_t{"LightPurple", ImVec4(0.87F, 0.58F, 0.98F, 1.00f)},
+    NamedColor_t{"VeryLightPurple", ImVec4(0.94F, 0.81F, 0.99F, 1.00f)},
+});
+
+/// Markers accepted by symbol or name in the MarkerShapes field
+inline constexpr auto MARKER_TABLE = std::to_array<NamedMarker_t>({
+    NamedMarker_t{"o", "circle", ImPlotMarker_Circle},
+    NamedMarker_t{"s", "square", ImPlotMarker_Square},
+    NamedMarker_t{"d", "diamond", ImPlotMarker_Diamond},
+    NamedMarker_t{"^", "triangle (up)", ImPlotMarker_Up},
+    NamedMarker_t{"v", "triangle (down)", ImPlotMarker_Down},
+    NamedMarker_t{"<", "triangle (left)", ImPlotMarker_Left},
+    NamedMarker_t{">", "triangle (right)", ImPlotMarker_Right},
+    NamedMarker_t{"x", "x-mark", ImPlotMarker_Cross},
+    NamedMarker_t{"+", "plus", ImPlotMarker_Plus},
+    NamedMarker_t{"*", "star", ImPlotMarker_Asterisk},
+});
+
+/// ASCII lower case, usable at compile time
+constexpr char foldCase(char character)
+{
+    return character >= 'A' && character <= 'Z' ? static_cast<char>(character - 'A' + 'a') : character;
+}
+
+/// FNV-1a, usable at compile time. With ignoreCase names differing only in ASCII case hash alike.
+constexpr uint64_t hashName(std::string_view name, bool ignoreCase = false)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const char character : name)
+    {
+        hash = (hash ^ static_cast<uint8_t>(ignoreCase ? foldCase(character) : character)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+/// Open-addressing table from a name to its position in a list, filled at
+/// compile time. With Slots at least twice the number of names a lookup is
+/// one hash and a probe or two; nothing is allocated.
+template <size_t Slots, bool IgnoreCase = false>
+class NameIndex_t
+{
+    static_assert(Slots > 1 && (Slots & (Slots - 1)) == 0, "Slots must be a power of two");
+
+  public:
+    static constexpr size_t NONE = SIZE_MAX;
+
+    template <size_t N>
+    constexpr explicit NameIndex_t(const std::array<std::string_view, N>& names)
+    {
+        static_assert(2 * N <= Slots, "Too many names for the number of slots");
+        for (size_t index = 0; index < N; index++)
+        {
+            size_t slot = hashName(names[index], IgnoreCase) & MASK;
+            while (mSlots[slot].position != NONE)
+            {
+                slot = (slot + 1) & MASK;
+            }
+            mSlots[slot] = {names[index], index};
+        }
+    }
+
+    /// <returns>Position of name in the list the table was built from, NONE if it is not there</returns>
+    constexpr size_t find(std::string_view name) const
+    {
+        for (size_t slot = hashName(name, IgnoreCase) & MASK; mSlots[slot].position != NONE; slot = (slot + 1) & MASK)
+        {
+            if (equal(mSlots[slot].name, name))
+            {
+                return mSlots[slot].position;
+            }
+        }
+        return NONE;
+    }
+
+  private:
+    static constexpr size_t MASK = Slots - 1;
+
+    static constexpr bool equal(std::string_view left, std::string_view right)
+    {
+        if (!IgnoreCase || left.size() != right.size())
+        {
+            return left == right;
+        }
+        for (size_t index = 0; index < left.size(); index++)
+        {
+            if (foldCase(left[index]) != foldCase(right[index]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    struct Slot_t
+    {
+        std::string_view name;
+        size_t           position = NONE;
+    };
+    std::array<Slot_t, Slots> mSlots = {};
+};
+
+inline constexpr NameIndex_t<256> COLOR_INDEX = NameIndex_t<256>(
+    []()
+    {
+        std::array<std::string_view, COLOR_TABLE.size()> names = {};
+        for (size_t index = 0; index < COLOR_TABLE.size(); index++)
+        {
+            names[index] = COLOR_TABLE[index].name;
+        }
+        return names;
+    }());
+
+/// Symbols take positions 0..N-1 and names N..2N-1
+inline constexpr NameIndex_t<64> MARKER_INDEX = NameIndex_t<64>(
+    []()
+    {
+        std::array<std::string_view, 2 * MARKER_TABLE.size()> names = {};
+        for (size_t index = 0; index < MARKER_TABLE.size(); index++)
+        {
+            names[index]                       = MARKER_TABLE[index].symbol;
+            names[MARKER_TABLE.size() + index] = MARKER_TABLE[index].name;
+        }
+        return names;
+    }());
+
+/// Every name must lead back to its own entry, which also rules out duplicates
+constexpr bool checkStyleIndices()
+{
+    for (size_t index = 0; index < COLOR_TABLE.size(); index++)
+    {
+        if (COLOR_INDEX.find(COLOR_TABLE[index].name) != index)
+        {
+            return false;
+        }
+    }
+    for (size_t index = 0; index < MARKER_TABLE.size(); index++)
+    {
+        if (MARKER_INDEX.find(MARKER_TABLE[index].symbol) != index ||
+            MARKER_INDEX.find(MARKER_TABLE[index].name) != MARKER_TABLE.size() + index)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(checkStyleIndices(), "Color and marker names must be unique");
+
+/// Value of a hex digit, -1 for anything else
+constexpr int hexDigit(char character)
+{
+    return character >= '0' && character <= '9'   ? character - '0'
+           : character >= 'a' && character <= 'f' ? character - 'a' + 10
+           : character >= 'A' && character <= 'F' ? character - 'A' + 10
+                                                  : -1;
+}
+
+/// <summary>
+/// Color of a Colors entry: a name of COLOR_TABLE, a hex string "#RGB", "#RRGGBB" or "#RRGGBBAA",
+/// or an RGB(A) triplet in [0, 1] as MATLAB writes it, e.g. "[0 0.447 0.741]" or "0,0.5,1".
+/// Nothing is allocated.
+/// </summary>
+inline std::optional<ImVec4> findColor(std::string_view text)
+{
+    const size_t position = COLOR_INDEX.find(text);
+    if (position != COLOR_INDEX.NONE)
+    {
+        return COLOR_TABLE[position].color;
+    }
+
+    if (!text.empty() && text.front() == '#')
+    {
+        const std::string_view digits = text.substr(1);
+        if (digits.size() != 3 && digits.size() != 6 && digits.size() != 8)
+        {
+            return std::nullopt;
+        }
+        const size_t width = digits.size() == 3 ? 1 : 2; // "#RGB" stands for "#RRGGBB"
+        const size_t count = digits.size() / width;
+        float channels[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        for (size_t channel = 0; channel < count; channel++)
+        {
+            const int high = hexDigit(digits[channel * width]);
+            const int low  = hexDigit(digits[channel * width + width - 1]);
+            if (high < 0 || low < 0)
+            {
+                return std::nullopt;
+            }
+            channels[channel] = static_cast<float>(high * 16 + low) / 255.0f;
+        }
+        return ImVec4(channels[0], channels[1], channels[2], channels[3]);
+    }
+
+    // triplet, optionally bracketed, separated by spaces and/or commas
+    float       channels[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    size_t      count       = 0;
+    const char* current     = text.data();
+    const char* last        = text.data() + text.size();
+    while (current != last)
+    {
+        if (*current == ' ' || *current == ',' || *current == '[' || *current == ']')
+        {
+            current++;
+            continue;
+        }
+        float value  = 0.0f;
+        auto  result = std::from_chars(current, last, value);
+        if (result.ec != std::errc() || count == 4 || value < 0.0f || value > 1.0f)
+        {
+            return std::nullopt;
+        }
+        channels[count++] = value;
+        current           = result.ptr;
+    }
+    if (count < 3)
+    {
+        return std::nullopt;
+    }
+    return ImVec4(channels[0], channels[1], channels[2], channels[3]);
+}
+
+/// <summary>
+/// Marker of a MarkerShapes entry, by symbol ("o") or name ("circle")
+/// </summary>
+inline std::optional<ImPlotMarker_> findMarker(std::string_view text)
+{
+    const size_t position = MARKER_INDEX.find(text);
+    if (position == MARKER_INDEX.NONE)
+    {
+        return std::nullopt;
+    }
+    return MARKER_TABLE[position % MARKER_TABLE.size()].marker;
+}
+} // namespace ImPlot
@@ -0,0 +1,148 @@
+#pragma once
+
+/// STL headers
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ImPlot
+{
+/// Fixed set of worker threads running submitted jobs in FIFO order. Results
+/// come back through std::future, so the render thread can poll them with
+/// wait_for(0) and keep drawing while a job is in flight.
+class ThreadPool_t
+{
+  public:
+    explicit ThreadPool_t(size_t numThreads = getDefaultThreadCount())
+    {
+        for (size_t index = 0; index < numThreads; index++)
+        {
+            mWorkers.emplace_back(&ThreadPool_t::work, this);
+        }
+    }
+
+    ~ThreadPool_t()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping = true;
+        }
+        mWake.notify_all();
+        for (auto& worker : mWorkers)
+        {
+            worker.join();
+        }
+    }
+
+    ThreadPool_t(const ThreadPool_t&)            = delete;
+    ThreadPool_t& operator=(const ThreadPool_t&) = delete;
+
+    /// <summary>
+    /// One thread less than the cores, leaving one to the caller; hardware_concurrency() is 0 if unknown
+    /// </summary>
+    static size_t getDefaultThreadCount()
+    {
+        const unsigned cores = std::thread::hardware_concurrency();
+        return cores > 1 ? cores - 1 : 1;
+    }
+
+    /// <summary>
+    /// Queue a job; jobs still queued when the pool is destroyed are run first
+    /// </summary>
+    template <class F>
+    std::future<std::invoke_result_t<F>> submit(F&& job)
+    {
+        auto task   = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(job));
+        auto result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mJobs.emplace_back([task]() { (*task)(); });
+        }
+        mWake.notify_one();
+        return result;
+    }
+
+    /// <summary>
+    /// Run job(index) for every index in [0, count) on the workers and the calling thread. Each
+    /// thread claims the next index when it is done with one, so jobs of uneven cost balance out
+    /// across the machine. Returns once all jobs are done, rethrowing the first exception of any.
+    /// </summary>
+    template <class F>
+    void parallelFor(size_t count, F&& job)
+    {
+        std::atomic<size_t> next = 0;
+        std::exception_ptr  failure;
+        std::mutex          failureMutex;
+        auto                run = [&]()
+        {
+            for (size_t index = next++; index < count; index = next++)
+            {
+                try
+                {
+                    job(index);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(failureMutex);
+                    failure = failure ? failure : std::current_exception();
+                }
+            }
+        };
+
+        std::vector<std::future<void>> helpers;
+        for (size_t helper = 0; helper + 1 < std::min(count, size() + 1); helper++)
+        {
+            helpers.push_back(submit(run));
+        }
+        run();
+        for (auto& helper : helpers)
+        {
+            helper.wait();
+        }
+        if (failure)
+        {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    size_t size() const
+    {
+        return mWorkers.size();
+    }
+
+  private:
+    void work()
+    {
+        for (;;)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWake.wait(lock, [this]() { return mStopping || !mJobs.empty(); });
+                if (mJobs.empty())
+                {
+                    return;
+                }
+                job = std::move(mJobs.front());
+                mJobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::vector<std::thread>          mWorkers;
+    std::deque<std::function<void()>> mJobs;
+    std::mutex                        mMutex;
+    std::condition_variable           mWake;
+    bool                              mStopping = false;
+};
+} // namespace ImPlot
@@ -0,0 +1,275 @@
+#include "ImGuiContextManager.h"
+
+#include <cstdlib>
+
+std::atomic<bool>   ImGuiContextManager::mInitialized     = false;
+std::atomic<size_t> ImGuiContextManager::mLiveBytes       = 0;
+std::atomic<size_t> ImGuiContextManager::mLiveAllocations = 0;
+
+namespace
+{
+/// Room in front of every block to remember its size, keeping the block aligned
+constexpr size_t ALLOCATION_HEADER = alignof(std::max_align_t);
+} // namespace
+
+ImGuiContextManager::~ImGuiContextManager()
+{
+    shutdown();
+}
+
+ImGuiContextManager& ImGuiContextManager::getInstance()
+{
+    static ImGuiContextManager instance;
+    return instance;
+}
+
+GLFWwindow* ImGuiContextManager::acquire()
+{
+    if (!makeCurrent())
+    {
+        return NULL;
+    }
+
+    glfwSetWindowShouldClose(mWindow, GLFW_FALSE);
+    glfwShowWindow(mWindow);
+
+    GLFWmonitor*       monitor = glfwGetPrimaryMonitor();
+    const GLFWvidmode* mode    = monitor ? glfwGetVideoMode(monitor) : NULL;
+    mRefreshRate               = mode && mode->refreshRate > 0 ? mode->refreshRate : DEFAULT_REFRESH_RATE;
+    return mWindow;
+}
+
+bool ImGuiContextManager::makeCurrent()
+{
+    if (mWindow == NULL && !initialize())
+    {
+        return false;
+    }
+
+    glfwMakeContextCurrent(mWindow);
+    ImGui::SetCurrentContext(mImGuiContext);
+    ImPlot::SetCurrentContext(mImPlotContext);
+    return true;
+}
+
+std::vector<ImPlot::OffscreenContext_t*> ImGuiContextManager::getOffscreenContexts(size_t count)
+{
+    std::vector<ImPlot::OffscreenContext_t*> contexts;
+    if (!makeCurrent())
+    {
+        return contexts;
+    }
+
+    while (mOffscreenContexts.size() < count)
+    {
+        auto context = createOffscreenContext();
+        if (!context)
+        {
+            break;
+        }
+        mOffscreenContexts.push_back(std::move(context));
+    }
+    makeCurrent();
+
+    for (size_t index = 0; index < std::min(count, mOffscreenContexts.size()); index++)
+    {
+        contexts.push_back(mOffscreenContexts[index].get());
+    }
+    return contexts;
+}
+
+std::unique_ptr<ImPlot::OffscreenContext_t> ImGuiContextManager::createOffscreenContext()
+{
+    // windows are created hidden, see initialize
+    auto context    = std::make_unique<ImPlot::OffscreenContext_t>();
+    context->window = glfwCreateWindow(1, 1, "Matlab ImGui export", NULL, NULL);
+    if (context->window == NULL)
+    {
+        return NULL;
+    }
+    glfwMakeContextCurrent(context->window);
+
+    context->imGuiContext = ImGui::CreateContext();
+    ImGui::SetCurrentContext(context->imGuiContext);
+    context->imPlotContext = ImPlot::CreateContext();
+    ImGui::GetIO().IniFilename = NULL;
+    ImGui::StyleColorsDark();
+    ImGui_ImplOpenGL3_Init("#version 130");
+
+    glfwMakeContextCurrent(NULL);
+    return context;
+}
+
+void ImGuiContextManager::release()
+{
+    if (mWindow != NULL)
+    {
+        glfwHideWindow(mWindow);
+        glfwPollEvents(); // let the hide reach the window system
+    }
+}
+
+bool ImGuiContextManager::takeWindowEvents()
+{
+    const bool events = mWindowEvents;
+    mWindowEvents     = false;
+    return events;
+}
+
+void ImGuiContextManager::wake()
+{
+    if (mInitialized)
+    {
+        glfwPostEmptyEvent();
+    }
+}
+
+ImPlot::ContextMemory_t ImGuiContextManager::getMemoryUsage()
+{
+    return {mLiveBytes.load(std::memory_order_relaxed), mLiveAllocations.load(std::memory_order_relaxed)};
+}
+
+void* ImGuiContextManager::allocate(size_t size, void* userData)
+{
+    (void) userData;
+    auto* block = static_cast<unsigned char*>(std::malloc(size + ALLOCATION_HEADER));
+    if (block == NULL)
+    {
+        return NULL;
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    mLiveBytes.fetch_add(size, std::memory_order_relaxed);
+    mLiveAllocations.fetch_add(1, std::memory_order_relaxed);
+    return block + ALLOCATION_HEADER;
+}
+
+void ImGuiContextManager::deallocate(void* ptr, void* userData)
+{
+    (void) userData;
+    if (ptr == NULL)
+    {
+        return;
+    }
+    auto* block = static_cast<unsigned char*>(ptr) - ALLOCATION_HEADER;
+    mLiveBytes.fetch_sub(*reinterpret_cast<size_t*>(block), std::memory_order_relaxed);
+    mLiveAllocations.fetch_sub(1, std::memory_order_relaxed);
+    std::free(block);
+}
+
+bool ImGuiContextManager::initialize()
+{
+    // Setup window
+    glfwSetErrorCallback(glfw_error_callback);
+    if (!glfwInit())
+    {
+        std::cout << "glfw is not ini" << std::endl;
+        return false;
+    }
+    const char* glsl_version = "#version 130";
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE); // shown by acquire, never for offscreen drawing alone
+
+    // Create window with graphics context
+    mWindow = glfwCreateWindow(1280, 720, "Matlab ImGui", NULL, NULL);
+    if (mWindow == NULL)
+    {
+        std::cout << "Issue creating window's graphics context" << std::endl;
+        glfwTerminate();
+        return false;
+    }
+    glfwMakeContextCurrent(mWindow);
+    glfwSwapInterval(1);
+    mInitialized = true;
+
+    bool err = glewInit() != GLEW_OK;
+    if (err)
+    {
+        fprintf(stderr, "Failed to initialize OpenGL loader!\n");
+        std::cout << "Issue from glew ini" << std::endl;
+    }
+
+    int screen_width, screen_height;
+    glfwGetFramebufferSize(mWindow, &screen_width, &screen_height);
+    glViewport(0, 0, screen_width, screen_height);
+
+    // Setup Dear ImGui and ImPlot contexts, once for the lifetime of the window
+    IMGUI_CHECKVERSION();
+    ImGui::SetAllocatorFunctions(allocate, deallocate);
+    mImGuiContext = ImGui::CreateContext();
+    ImGui::SetCurrentContext(mImGuiContext);
+    mImPlotContext = ImPlot::CreateContext();
+    ImPlot::SetCurrentContext(mImPlotContext);
+
+    ImGuiIO& io = ImGui::GetIO();
+    io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard; // Enable Keyboard Controls
+    io.ConfigWindowsMoveFromTitleBarOnly = true;          // Allows mouse functions in world visualization
+
+    // Setup Platform/Renderer bindings, the backend forwards input to the callbacks installed before it
+    installEventCallbacks();
+    ImGui_ImplGlfw_InitForOpenGL(mWindow, true);
+    ImGui_ImplOpenGL3_Init(glsl_version);
+    ImGui::StyleColorsDark(); // Setup Dear ImGui style
+
+    return true;
+}
+
+void ImGuiContextManager::shutdown()
+{
+    if (mWindow == NULL)
+    {
+        return;
+    }
+
+    for (auto& context : mOffscreenContexts)
+    {
+        glfwMakeContextCurrent(context->window);
+        context->target.release();
+        ImGui::SetCurrentContext(context->imGuiContext);
+        ImGui_ImplOpenGL3_Shutdown();
+        ImPlot::DestroyContext(context->imPlotContext);
+        ImGui::DestroyContext(context->imGuiContext);
+        glfwDestroyWindow(context->window);
+    }
+    mOffscreenContexts.clear();
+
+    glfwMakeContextCurrent(mWindow);
+    ImGui::SetCurrentContext(mImGuiContext);
+
+    // Cleanup
+    ImGui_ImplOpenGL3_Shutdown();
+    ImGui_ImplGlfw_Shutdown();
+    ImPlot::DestroyContext(mImPlotContext);
+    ImGui::DestroyContext(mImGuiContext);
+    glfwDestroyWindow(mWindow);
+    mInitialized = false;
+    glfwTerminate();
+
+    mImPlotContext = nullptr;
+    mImGuiContext  = nullptr;
+    mWindow        = nullptr;
+}
+
+void ImGuiContextManager::installEventCallbacks()
+{
+    glfwSetCursorPosCallback(mWindow, [](GLFWwindow*, double, double) { getInstance().mWindowEvents = true; });
+    glfwSetCursorEnterCallback(mWindow, [](GLFWwindow*, int) { getInstance().mWindowEvents = true; });
+    glfwSetMouseButtonCallback(mWindow, [](GLFWwindow*, int, int, int) { getInstance().mWindowEvents = true; });
+    glfwSetScrollCallback(mWindow, [](GLFWwindow*, double, double) { getInstance().mWindowEvents = true; });
+    glfwSetKeyCallback(mWindow, [](GLFWwindow*, int, int, int, int) { getInstance().mWindowEvents = true; });
+    glfwSetCharCallback(mWindow, [](GLFWwindow*, unsigned int) { getInstance().mWindowEvents = true; });
+    glfwSetWindowFocusCallback(mWindow,
+                               [](GLFWwindow*, int focused)
+                               {
+                                   getInstance().mFocused      = focused == GLFW_TRUE;
+                                   getInstance().mWindowEvents = true;
+                               });
+    glfwSetFramebufferSizeCallback(mWindow, [](GLFWwindow*, int, int) { getInstance().mWindowEvents = true; });
+    glfwSetWindowRefreshCallback(mWindow, [](GLFWwindow*) { getInstance().mWindowEvents = true; });
+    glfwSetWindowIconifyCallback(mWindow,
+                                 [](GLFWwindow*, int iconified)
+                                 {
+                                     getInstance().mIconified    = iconified == GLFW_TRUE;
+                                     getInstance().mWindowEvents = true;
+                                 });
+}
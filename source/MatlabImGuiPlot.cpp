@@ -1,9 +1,19 @@
+// implot_internal.h needs ImGui's ImVec2 operators, which are only declared if asked for before imgui.h
+#ifndef IMGUI_DEFINE_MATH_OPERATORS
+#define IMGUI_DEFINE_MATH_OPERATORS
+#endif
 #include "MatlabImGuiPlot.h"
+#include "implot_internal.h"
 
-void MatlabImGuiPlot::errorCheck(ImPlot::PlotData_t& data)
+void MatlabImGuiPlot::errorCheck(const ImPlot::PlotData_t& data)
 {
-    size_t     dimensions = data.getData1().size();
-    const auto plotInfo   = data.getPlotInfo();
+    size_t      dimensions = data.getData2().size();
+    const auto& plotInfo   = data.getPlotInfo();
+
+    if (!plotInfo.implicitX && (data.getData1().size() != dimensions || data.getData1().rows != data.getData2().rows()))
+    {
+        throw std::invalid_argument("Input data1 and data2 dimensions are not equal");
+    }
 
     if (plotInfo.plotTypesAvailable)
     {
@@ -11,6 +21,14 @@ void MatlabImGuiPlot::errorCheck(ImPlot::PlotData_t& data)
         {
             throw std::invalid_argument("Input and plot type dimensions are not equal");
         }
+        const auto plotTypes = getAvailablePlotTypes();
+        for (const auto& plotType : data.getPlotTypes())
+        {
+            if (std::find(plotTypes.begin(), plotTypes.end(), plotType) == plotTypes.end())
+            {
+                throw std::invalid_argument("Plot types must be \"Line\", \"Scatter\" or \"Bars\"");
+            }
+        }
     }
 
     if (plotInfo.markerShapesAvailable)
@@ -92,61 +110,657 @@ void MatlabImGuiPlot::errorCheck(ImPlot::PlotData_t& data)
             throw std::invalid_argument("Input and UncertaintyUpperBound dimensions are not equal");
         }
     }
+
+    if (plotInfo.decimationAvailable)
+    {
+        if (data.getDecimation().size() != dimensions)
+        {
+            throw std::invalid_argument("Input and decimation dimensions are not equal");
+        }
+        const auto decimations = getAvailableDecimations();
+        for (const auto& decimation : data.getDecimation())
+        {
+            if (std::find(decimations.begin(), decimations.end(), decimation) == decimations.end())
+            {
+                throw std::invalid_argument("Decimation must be \"none\", \"minmax\" or \"lttb\"");
+            }
+        }
+    }
+
+    if (plotInfo.capacityAvailable)
+    {
+        if (data.getCapacity().size() != ImPlot::Dimension_e::ONE || !(data.getCapacity()[0] >= 1))
+        {
+            throw std::invalid_argument("Capacity must be a single positive number of samples");
+        }
+    }
+
+    if (plotInfo.sampleRateAvailable)
+    {
+        const auto& sampleRate = data.getSampleRate();
+        if (sampleRate.size() != ImPlot::Dimension_e::ONE || !(sampleRate[0] > 0) || !std::isfinite(sampleRate[0]))
+        {
+            throw std::invalid_argument("SampleRate must be a single positive number of samples per unit of x");
+        }
+    }
+
+    if (plotInfo.startTimeAvailable)
+    {
+        if (data.getStartTime().size() != ImPlot::Dimension_e::ONE || !std::isfinite(data.getStartTime()[0]))
+        {
+            throw std::invalid_argument("StartTime must be a single finite number");
+        }
+    }
+}
+
+void MatlabImGuiPlot::prepare(ImPlot::PlotData_t& data, const ImPlot::PlotData_t* previous)
+{
+    errorCheck(data);
+
+    if (previous == NULL || previous->getData1().values != data.getData1().values)
+    {
+        data.updateMonotonicX();
+    }
+    if (previous == NULL || previous->getData2().buffer() != data.getData2().buffer())
+    {
+        data.updateLevelsOfDetail();
+    }
+
+    const auto& plotInfo = data.getPlotInfo();
+    auto        commands = std::make_shared<std::vector<ImPlot::DrawCommand_t>>(data.getData2().size());
+    for (size_t index = ImPlot::Dimension_e::ZERO; index < commands->size(); index++)
+    {
+        auto& command = (*commands)[index];
+
+        if (plotInfo.plotTypesAvailable)
+        {
+            const auto& plotType = data.getPlotTypes()[index];
+            command.type         = plotType.compare("Scatter") == 0 ? ImPlot::PlotType_e::SCATTER
+                                   : plotType.compare("Bars") == 0  ? ImPlot::PlotType_e::BARS
+                                                                    : ImPlot::PlotType_e::LINE;
+        }
+
+        // lines default to the min/max pyramid, everything else to every sample
+        command.decimation =
+            command.type == ImPlot::PlotType_e::LINE ? ImPlot::Decimation_e::MINMAX : ImPlot::Decimation_e::NONE;
+        if (plotInfo.decimationAvailable)
+        {
+            const auto& decimation = data.getDecimation()[index];
+            command.decimation     = decimation.compare("lttb") == 0     ? ImPlot::Decimation_e::LTTB
+                                     : decimation.compare("minmax") == 0 ? ImPlot::Decimation_e::MINMAX
+                                                                         : ImPlot::Decimation_e::NONE;
+        }
+
+        if (plotInfo.legendsAvailable)
+        {
+            command.legend = data.getLegends().size() > ImPlot::Dimension_e::ZERO ? data.getLegends()[index] : " ";
+        }
+
+        command.colorAvailable = plotInfo.colorsAvailable;
+        if (plotInfo.colorsAvailable)
+        {
+            command.color = data.getColors()[index];
+        }
+        command.markerAvailable = plotInfo.markerShapesAvailable;
+        if (plotInfo.markerShapesAvailable)
+        {
+            command.marker = data.getMarkerShapes()[index];
+        }
+        command.lineWidthAvailable = plotInfo.lineWidthAvailable;
+        if (plotInfo.lineWidthAvailable)
+        {
+            command.lineWidth = static_cast<float>(data.getLineWidth()[index]);
+        }
+        if (plotInfo.markerSizeAvailable)
+        {
+            command.markerSize = static_cast<float>(data.getMarkerSize()[index]);
+        }
+
+        // implicit x is generated from start and scale when drawn, and increases by construction
+        command.x          = plotInfo.implicitX ? data.getImplicitX() : ImPlot::XData_t{data.getData1()[index].data()};
+        command.y          = data.getData2()[index];
+        command.monotonicX = plotInfo.implicitX || (index < data.getMonotonicX().size() && data.getMonotonicX()[index]);
+        command.shaded     = plotInfo.uncertaintyLowerBoundAvailable && plotInfo.uncertaintyUpperBoundAvailable;
+        if (command.shaded)
+        {
+            command.lower = data.getUncertaintyLowerBound()[index];
+            command.upper = data.getUncertaintyUpperBound()[index];
+        }
+
+        // buckets of the pyramid are sample index ranges, which are equal x ranges only for evenly spaced x;
+        // on any other x they would drop x extremes, so every sample is drawn instead
+        const bool evenlySpaced =
+            plotInfo.implicitX || (index < data.getEvenlySpacedX().size() && data.getEvenlySpacedX()[index]);
+        const auto* pyramids = data.getLevelsOfDetail();
+        if (command.decimation == ImPlot::Decimation_e::MINMAX && !evenlySpaced)
+        {
+            command.decimation = ImPlot::Decimation_e::NONE;
+        }
+        if (command.decimation == ImPlot::Decimation_e::MINMAX && pyramids && index < pyramids->size())
+        {
+            command.pyramid = &(*pyramids)[index];
+        }
+    }
+    data.commands = std::move(commands);
+}
+
+MatlabImGuiPlot::~MatlabImGuiPlot()
+{
+    mRunning = false;
+    ImGuiContextManager::wake();
+    if (mRenderThread.joinable())
+    {
+        mRenderThread.join();
+    }
+}
+
+void MatlabImGuiPlot::show(std::vector<ImPlot::MatlabInput_t> data)
+{
+    mFigures.back() = std::move(data);
+    mFigures.publish();
+    ImGuiContextManager::wake();
+    start();
+}
+
+void MatlabImGuiPlot::start()
+{
+    if (!mRunning)
+    {
+        mRunning      = true;
+        mRenderThread = std::thread(&MatlabImGuiPlot::renderLoop, this);
+    }
+}
+
+void MatlabImGuiPlot::exportFigures(std::vector<ImPlot::ExportJob_t> jobs)
+{
+    std::future<void> done;
+    {
+        std::lock_guard<std::mutex> lock(mExportMutex);
+        mExportRequests.push_back({std::move(jobs), {}});
+        done = mExportRequests.back().done.get_future();
+    }
+    ImGuiContextManager::wake();
+    start();
+    done.get();
+}
+
+bool MatlabImGuiPlot::processExports()
+{
+    std::deque<ExportRequest_t> requests;
+    {
+        std::lock_guard<std::mutex> lock(mExportMutex);
+        requests.swap(mExportRequests);
+    }
+
+    for (auto& request : requests)
+    {
+        try
+        {
+            exportBatch(request.jobs);
+            request.done.set_value();
+        }
+        catch (...)
+        {
+            request.done.set_exception(std::current_exception());
+        }
+    }
+    return !requests.empty();
 }
 
-MatlabImGuiPlot::MatlabImGuiPlot(std::vector<ImPlot::MatlabInput_t>& data)
+void MatlabImGuiPlot::exportBatch(const std::vector<ImPlot::ExportJob_t>& jobs)
 {
-    mtx.lock();
+    auto& manager  = ImGuiContextManager::getInstance();
+    auto  contexts = manager.getOffscreenContexts(std::min(jobs.size(), MAX_EXPORT_CONTEXTS));
+    if (contexts.empty())
+    {
+        throw std::runtime_error("No OpenGL context to draw offscreen");
+    }
+    if (!mExportWorkers)
+    {
+        mExportWorkers = std::make_unique<ImPlot::ThreadPool_t>(MAX_EXPORT_CONTEXTS);
+        mEncoders      = std::make_unique<ImPlot::ThreadPool_t>();
+    }
+
+    std::atomic<size_t>            next = 0;
+    std::vector<std::string>       errors(jobs.size());
+    std::vector<std::future<void>> encodes(jobs.size());
+    std::counting_semaphore<>      pending(static_cast<ptrdiff_t>(PENDING_IMAGES_PER_ENCODER * mEncoders->size()));
+
+    // each worker keeps one context current for the whole batch and takes figures until none is left
+    std::vector<std::future<void>> workers;
+    for (auto* context : contexts)
+    {
+        workers.push_back(mExportWorkers->submit(
+            [&, context]()
+            {
+                glfwMakeContextCurrent(context->window);
+                for (size_t index = next++; index < jobs.size(); index = next++)
+                {
+                    try
+                    {
+                        auto pixels = renderOffscreen(*context, jobs[index]);
+                        pending.acquire();
+                        encodes[index] = mEncoders->submit(
+                            [&jobs, &pending, index, pixels = std::move(pixels)]()
+                            {
+                                const auto& job     = jobs[index];
+                                const bool  written = ImPlot::OffscreenTarget_t::writePng(
+                                    job.fileName, job.width, job.height, pixels);
+                                pending.release();
+                                if (!written)
+                                {
+                                    throw std::runtime_error("Cannot write " + job.fileName);
+                                }
+                            });
+                    }
+                    catch (const std::exception& error)
+                    {
+                        errors[index] = error.what();
+                    }
+                }
+                glfwMakeContextCurrent(NULL);
+            }));
+    }
+    for (auto& worker : workers)
+    {
+        worker.wait();
+    }
+    for (size_t index = 0; index < jobs.size(); index++)
+    {
+        try
+        {
+            if (encodes[index].valid())
+            {
+                encodes[index].get();
+            }
+        }
+        catch (const std::exception& error)
+        {
+            errors[index] = error.what();
+        }
+    }
+
+    // the workers left the ImGui and ImPlot globals on their contexts
+    manager.makeCurrent();
+    for (const auto& error : errors)
+    {
+        if (!error.empty())
+        {
+            throw std::runtime_error(error);
+        }
+    }
+}
+
+std::vector<unsigned char> MatlabImGuiPlot::renderOffscreen(ImPlot::OffscreenContext_t& context,
+                                                            const ImPlot::ExportJob_t&  job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mFrameMutex);
+        ImGui::SetCurrentContext(context.imGuiContext);
+        ImPlot::SetCurrentContext(context.imPlotContext);
+        if (job.width <= 0 || job.height <= 0 || !context.target.bind(job.width, job.height))
+        {
+            throw std::runtime_error("Cannot draw a " + std::to_string(job.width) + "x" +
+                                     std::to_string(job.height) + " image of " + job.figure.figureConfig);
+        }
+
+        // one ImGui window for every export, so nothing is left behind per figure
+        std::vector<ImPlot::MatlabInput_t> figures = {job.figure};
+        figures[0].windowTitle                     = "##export";
+
+        ImGuiIO& io                = ImGui::GetIO();
+        io.DisplaySize             = ImVec2(static_cast<float>(job.width), static_cast<float>(job.height));
+        io.DisplayFramebufferScale = ImVec2(1.0f, 1.0f);
+        io.DeltaTime               = 1.0f / 60.0f;
+        for (int frame = 0; frame < EXPORT_FRAMES; frame++)
+        {
+            glClearColor(0.45f, 0.55f, 0.60f, 1.00f);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            ImGui_ImplOpenGL3_NewFrame();
+            ImGui::NewFrame();
+
+            processPlots(figures, true);
+
+            ImGui::Render();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
+    }
+
+    // the driver finishes drawing this figure while other workers build theirs
+    auto pixels = context.target.readPixels();
+    context.target.unbind();
+    return pixels;
+}
 
-    // Setup window
-    glfwSetErrorCallback(glfw_error_callback);
-    if (!glfwInit())
+void MatlabImGuiPlot::append(ImPlot::AppendPacket_t packet)
+{
+    // the render thread drains the queue every frame, so a full queue only waits for the next one
+    while (!mAppends.tryPush(packet))
+    {
+        std::this_thread::yield();
+    }
+    ImGuiContextManager::wake();
+}
+
+void MatlabImGuiPlot::consumeAppends(bool& figuresChanged)
+{
+    ImPlot::AppendPacket_t packet;
+    while (mAppends.tryPop(packet))
+    {
+        auto stream = mStreams.find({packet.handle, packet.subplot});
+
+        // a packet is pushed after its figure was published, which may not have been taken yet
+        if (stream == mStreams.end() && mFigures.update())
+        {
+            figuresChanged = true;
+            syncFigures();
+            stream = mStreams.find({packet.handle, packet.subplot});
+        }
+        if (stream == mStreams.end())
+        {
+            continue; // figure closed since
+        }
+
+        auto&       series    = stream->second.series;
+        const auto& implicitX = stream->second.implicitX;
+        packet.data2.visit(
+            [&series, &implicitX, &packet](const auto& columns)
+            {
+                for (size_t column = 0; column < std::min(series.size(), columns.size()); column++)
+                {
+                    const auto y = columns[column];
+                    std::visit(
+                        [&](auto& ring)
+                        {
+                            if (packet.implicitX)
+                            {
+                                ring.append(implicitX.from(ring.count()), y);
+                            }
+                            else
+                            {
+                                ring.append(packet.data1[column], y);
+                            }
+                        },
+                        series[column]);
+                }
+            });
+        stream->second.updateBounds();
+        markDirty(packet.handle);
+    }
+}
+
+const ImPlot::DecimatedSeries_t* MatlabImGuiPlot::decimate(uint64_t                  handle,
+                                                           size_t                    subplot,
+                                                           size_t                    index,
+                                                           const ImPlot::PlotData_t& data)
+{
+    auto& cache = mDecimations[{handle, subplot, index}];
+    if (cache.source != data.getData2().buffer())
+    {
+        cache        = {};
+        cache.source = data.getData2().buffer();
+    }
+
+    if (cache.pending.valid() && cache.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        cache.ready = cache.pending.get();
+    }
+
+    // about two samples per pixel column of the visible range
+    const ImPlotRect limits    = ImPlot::GetPlotLimits();
+    const size_t     threshold = 2 * static_cast<size_t>(std::max(1.0f, ImPlot::GetPlotSize().x));
+    const bool       current =
+        cache.threshold == threshold && cache.xMin == limits.X.Min && cache.xMax == limits.X.Max;
+    if (!current && !cache.pending.valid())
+    {
+        if (!mWorkers)
+        {
+            mWorkers = std::make_unique<ImPlot::ThreadPool_t>();
+        }
+
+        cache.xMin      = limits.X.Min;
+        cache.xMax      = limits.X.Max;
+        cache.threshold = threshold;
+
+        // only the visible slice when x is monotonic
+        const auto& command = data.getDrawCommands()[index];
+        size_t      first   = 0;
+        size_t      count   = command.size();
+        if (command.monotonicX)
+        {
+            std::tie(first, count) = getVisibleRange(command.x, count, limits.X);
+        }
+        const ImPlot::XData_t xSeries = command.x.from(first);
+
+        // the job holds the sample buffers, so the figure may be closed while it runs
+        cache.pending = data.getData2().visit(
+            [&](const auto& columns)
+            {
+                return mWorkers->submit(
+                    [xValues = data.getData1().values,
+                     yValues = columns.values,
+                     xSeries,
+                     ySeries = columns[index].subspan(first, count),
+                     limits,
+                     threshold]()
+                    {
+                        auto result = std::make_shared<const ImPlot::DecimatedSeries_t>(
+                            ImPlot::largestTriangleThreeBuckets(
+                                xSeries, ySeries, limits.X.Min, limits.X.Max, threshold));
+                        ImGuiContextManager::wake(); // an idle window picks the result up at once
+                        return result;
+                    });
+            });
+    }
+
+    return cache.ready.get();
+}
+
+const ImPlot::StreamData_t* MatlabImGuiPlot::findStream(uint64_t handle, size_t subplot) const
+{
+    auto stream = mStreams.find({handle, subplot});
+    return stream == mStreams.end() ? NULL : &stream->second;
+}
+
+void MatlabImGuiPlot::syncFigures()
+{
+    std::map<std::pair<uint64_t, size_t>, ImPlot::StreamData_t> streams;
+    for (const auto& figure : mFigures.front())
     {
-        std::cout << "glfw is not ini" << std::endl;
+        const auto& plotData = figure.getMatlabPlotData();
+        for (size_t subplot = 0; subplot < plotData.size(); subplot++)
+        {
+            const auto& data = plotData[subplot];
+            if (!data.getPlotInfo().capacityAvailable)
+            {
+                continue;
+            }
+
+            const size_t capacity = static_cast<size_t>(data.getCapacity()[0]);
+            const auto   key      = std::make_pair(figure.handle, subplot);
+            auto         previous = mStreams.find(key);
+            if (previous != mStreams.end() && previous->second.source == data.getData2().buffer() &&
+                previous->second.series.size() == data.getData2().size() &&
+                previous->second.capacity == capacity)
+            {
+                streams[key] = std::move(previous->second);
+                continue;
+            }
+
+            auto& stream     = streams[key];
+            stream.source    = data.getData2().buffer();
+            stream.capacity  = capacity;
+            stream.implicitX = data.getImplicitX();
+            data.getData2().visit(
+                [&stream, &data, capacity](const auto& columns)
+                {
+                    // rings keep y in the type the subplot was created with
+                    typedef ImPlot::RingBuffer_t<typename std::decay_t<decltype(columns)>::value_type> Ring_t;
+                    stream.series.assign(columns.size(), Ring_t(capacity));
+                    for (size_t column = 0; column < stream.series.size(); column++)
+                    {
+                        auto& ring = std::get<Ring_t>(stream.series[column]);
+                        if (data.getPlotInfo().implicitX)
+                        {
+                            ring.append(stream.implicitX, columns[column]);
+                        }
+                        else
+                        {
+                            ring.append(data.getData1()[column], columns[column]);
+                        }
+                    }
+                });
+            stream.updateBounds();
+        }
     }
-    const char* glsl_version = "#version 130";
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+    mStreams = std::move(streams);
 
-    // Create window with graphics context
-    GLFWwindow* window = glfwCreateWindow(1280, 720, "Matlab ImGui", NULL, NULL);
-    if (window == NULL)
+    // LTTB results of replaced data or closed figures
+    for (auto cache = mDecimations.begin(); cache != mDecimations.end();)
     {
-        std::cout << "Issue creating window's graphics context" << std::endl;
+        const auto figure = std::find_if(mFigures.front().begin(),
+                                         mFigures.front().end(),
+                                         [&cache](const auto& in) { return in.handle == cache->first[0]; });
+
+        bool keep = figure != mFigures.front().end() && cache->first[1] < figure->getMatlabPlotData().size();
+        keep      = keep && figure->getMatlabPlotData()[cache->first[1]].getData2().buffer() == cache->second.source;
+        cache     = keep ? std::next(cache) : mDecimations.erase(cache);
     }
-    glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);
+}
+
+void MatlabImGuiPlot::markDirty(uint64_t handle)
+{
+    mDirtyFrames[handle] = REDRAW_FRAMES;
+}
 
-    bool err = glewInit() != GLEW_OK;
-    if (err)
+void MatlabImGuiPlot::markAllDirty()
+{
+    mDirtyFrames.clear();
+    for (const auto& figure : mFigures.front())
     {
-        fprintf(stderr, "Failed to initialize OpenGL loader!\n");
-        std::cout << "Issue from glew ini" << std::endl;
+        mDirtyFrames[figure.handle] = REDRAW_FRAMES;
     }
+}
 
-    int screen_width, screen_height;
-    glfwGetFramebufferSize(window, &screen_width, &screen_height);
-    glViewport(0, 0, screen_width, screen_height);
+double MatlabImGuiPlot::getFrameRate(bool windowFocused, double refreshRate) const
+{
+    double rate = -1.0;
+    for (const auto& figure : mFigures.front())
+    {
+        const auto dirty = mDirtyFrames.find(figure.handle);
+        if (dirty != mDirtyFrames.end() && dirty->second > 0)
+        {
+            const bool hasFocus = windowFocused && figure.handle == mFocusedFigure;
+            rate                = ImPlot::FramePacer_t::fastest(rate, figure.frameRate.get(hasFocus), refreshRate);
+        }
+    }
+    return rate < 0.0 ? 0.0 : rate;
+}
 
-    // Setup Dear ImGui context
-    IMGUI_CHECKVERSION();
-    ImGui::CreateContext();
-    ImGuiIO& io = ImGui::GetIO();
-    (void) io;
-    io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard; // Enable Keyboard Controls
-    // io.ConfigFlags |= ImGuiConfigFlags_DockingEnable; // Enable Docking
-    // io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable; // Enable Multi-Viewport / Platform Windows
-    // io.ConfigViewportsNoAutoMerge = true; // Force all windows to use separate viewport
-    io.ConfigWindowsMoveFromTitleBarOnly = true; // Allows mouse functions in world visualization
+bool MatlabImGuiPlot::takeDirtyFrame()
+{
+    bool dirty = false;
+    for (auto& [handle, frames] : mDirtyFrames)
+    {
+        if (frames > 0)
+        {
+            dirty = true;
+            frames--;
+        }
+    }
+    return dirty;
+}
 
-    // Setup Platform/Renderer bindings
-    ImGui_ImplGlfw_InitForOpenGL(window, true);
-    ImGui_ImplOpenGL3_Init(glsl_version);
-    ImGui::StyleColorsDark(); // Setup Dear ImGui style
+void MatlabImGuiPlot::renderLoop()
+{
+    // Window and contexts live on this thread for as long as it runs
+    auto&       contexts = ImGuiContextManager::getInstance();
+    GLFWwindow* window   = NULL;
 
-    while (!glfwWindowShouldClose(window))
+    while (mRunning)
     {
+        bool figuresChanged = mFigures.update();
+        if (figuresChanged)
+        {
+            syncFigures();
+        }
+        consumeAppends(figuresChanged);
+
+        // Exports have contexts of their own, so they are drawn whether the window is shown or not
+        if (processExports())
+        {
+            mPacer.idle();
+        }
+
+        // New figures re-open the window if the user closed it, closing every figure hides it
+        if (figuresChanged)
+        {
+            if (mFigures.front().empty())
+            {
+                contexts.release();
+                window = NULL;
+            }
+            else
+            {
+                window = contexts.acquire();
+            }
+            markAllDirty();
+        }
+
+        if (window == NULL)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+
         glfwPollEvents();
+        if (glfwWindowShouldClose(window))
+        {
+            contexts.release();
+            window = NULL;
+            continue;
+        }
+
+        // Minimized: samples are still taken in, and everything is redrawn once the window is restored
+        if (contexts.isIconified())
+        {
+            glfwWaitEventsTimeout(IDLE_TIMEOUT_SECONDS);
+            continue;
+        }
+
+        // All figures share the window, so input or a resize redraws every one of them
+        if (contexts.takeWindowEvents())
+        {
+            markAllDirty();
+        }
+        for (auto& [key, cache] : mDecimations)
+        {
+            // taken here too, a figure that is not drawn would otherwise keep the window busy
+            if (cache.pending.valid() && cache.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            {
+                cache.ready = cache.pending.get();
+                markDirty(key[0]);
+            }
+        }
+
+        // Nothing changed: sleep until input, new figures or samples, or a finished LTTB job
+        const double rate = getFrameRate(contexts.isFocused(), contexts.getRefreshRate());
+        if (!takeDirtyFrame())
+        {
+            mPacer.idle();
+            glfwWaitEventsTimeout(IDLE_TIMEOUT_SECONDS);
+            continue;
+        }
+
+        // Vsync for the monitor's rate, otherwise the pacer sleeps to the rate asked for
+        if (ImPlot::FramePacer_t::getSwapInterval(rate) != mSwapInterval)
+        {
+            mSwapInterval = ImPlot::FramePacer_t::getSwapInterval(rate);
+            glfwSwapInterval(mSwapInterval);
+        }
+        mPacer.beginFrame(rate);
+
         glClearColor(0.45f, 0.55f, 0.60f, 1.00f);
         glClear(GL_COLOR_BUFFER_BIT);
 
@@ -155,10 +769,7 @@ MatlabImGuiPlot::MatlabImGuiPlot(std::vector<ImPlot::MatlabInput_t>& data)
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
-        ImGui::CreateContext();
-        ImPlot::CreateContext();
-
-        processPlots(data);
+        processPlots(mFigures.front());
 
         // Render dear imgui into screen
         ImGui::Render();
@@ -168,205 +779,451 @@ MatlabImGuiPlot::MatlabImGuiPlot(std::vector<ImPlot::MatlabInput_t>& data)
         glfwGetFramebufferSize(window, &display_w, &display_h);
         glViewport(0, 0, display_w, display_h);
         glfwSwapBuffers(window);
+        mPacer.endFrame();
+    }
+
+    contexts.shutdown();
+}
+
+template <class T>
+ImPlotPoint MatlabImGuiPlot::getLevelOfDetailPoint(int index, void* data)
+{
+    const auto*  view   = static_cast<const ImPlot::LevelOfDetailView_t<T>*>(data);
+    const size_t sample = view->buckets[static_cast<size_t>(index)];
+    return ImPlotPoint(view->x[sample], static_cast<double>(view->y[sample]));
+}
+
+template <class T>
+ImPlotPoint MatlabImGuiPlot::getRingSamplesPoint(int index, void* data)
+{
+    const auto*  view   = static_cast<const ImPlot::RingSamplesView_t<T>*>(data);
+    const size_t sample = view->samples[static_cast<size_t>(index)];
+    return ImPlotPoint(view->x[sample], static_cast<double>(view->y[sample]));
+}
+
+template <class T>
+ImPlotPoint MatlabImGuiPlot::getSeriesPoint(int index, void* data)
+{
+    const auto* view   = static_cast<const ImPlot::SeriesView_t<T>*>(data);
+    const int   sample = (view->offset + index) % view->count;
+    return ImPlotPoint(view->x[sample], static_cast<double>(view->y[sample]));
+}
+
+template <class T>
+void MatlabImGuiPlot::plotLine(const char*                    label,
+                               const ImPlot::XData_t&         xData,
+                               const T*                       yData,
+                               int                            first,
+                               int                            numElements,
+                               int                            offset,
+                               const ImPlot::MinMaxPyramid_t* pyramid,
+                               std::span<const size_t>        ringSamples)
+{
+    if (!ringSamples.empty())
+    {
+        ImPlot::RingSamplesView_t<T> view = {xData.values, yData, ringSamples};
+        ImPlot::PlotLineG(label, &getRingSamplesPoint<T>, &view, getPlotCount(ringSamples.size()));
+        return;
+    }
+    if (pyramid)
+    {
+        // two vertices per pixel column at most
+        const size_t width   = static_cast<size_t>(std::max(1.0f, ImPlot::GetPlotSize().x));
+        const size_t last    = static_cast<size_t>(first) + numElements;
+        const auto   buckets = pyramid->select(std::span<const T>(yData, last), first, last, width);
+        if (!buckets.empty())
+        {
+            ImPlot::LevelOfDetailView_t<T> view = {xData, yData, buckets};
+            ImPlot::PlotLineG(label, &getLevelOfDetailPoint<T>, &view, getPlotCount(buckets.size()));
+            return;
+        }
+    }
+    if (!xData.values)
+    {
+        const ImPlot::XData_t x = xData.from(first);
+        ImPlot::PlotLine(label, yData + first, numElements, x.scale, x.start, 0, offset);
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        ImPlot::PlotLine(label, xData.values + first, yData + first, numElements, 0, offset);
+    }
+    else
+    {
+        ImPlot::SeriesView_t<T> view = {xData.from(first), yData + first, std::max(numElements, 1), offset};
+        ImPlot::PlotLineG(label, &getSeriesPoint<T>, &view, numElements);
+    }
+}
+
+std::pair<size_t, size_t> MatlabImGuiPlot::getVisibleRange(const ImPlot::XData_t& x,
+                                                           size_t                 numElements,
+                                                           const ImPlotRange&     range)
+{
+    size_t first = 0;
+    size_t last  = 0;
+    if (x.values)
+    {
+        const auto lower = std::lower_bound(x.values, x.values + numElements, range.Min);
+        const auto upper = std::upper_bound(lower, x.values + numElements, range.Max);
+        first            = static_cast<size_t>(lower - x.values);
+        last             = static_cast<size_t>(upper - x.values);
+    }
+    else
+    {
+        // evenly spaced, the first and last sample in range follow from start and scale
+        const double total = static_cast<double>(numElements);
+        const double lower = std::clamp(std::ceil((range.Min - x.start) / x.scale), 0.0, total);
+        const double upper = std::clamp(std::floor((range.Max - x.start) / x.scale) + 1.0, lower, total);
+        first              = static_cast<size_t>(lower);
+        last               = static_cast<size_t>(upper);
     }
 
-    // Cleanup
-    ImGui_ImplOpenGL3_Shutdown();
-    ImGui_ImplGlfw_Shutdown();
-    ImGui::DestroyContext();
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    const size_t begin = first > 0 ? first - 1 : 0;
+    const size_t end   = std::min(last + 1, numElements);
+    return {begin, end - begin};
+}
 
-    mtx.unlock();
-};
+template <class T>
+void MatlabImGuiPlot::plotScatter(const char*                    label,
+                                  const ImPlot::XData_t&         xData,
+                                  const T*                       yData,
+                                  int                            first,
+                                  int                            numElements,
+                                  int                            offset,
+                                  const ImPlot::MinMaxPyramid_t* pyramid,
+                                  std::span<const size_t>        ringSamples)
+{
+    if (!ringSamples.empty())
+    {
+        ImPlot::RingSamplesView_t<T> view = {xData.values, yData, ringSamples};
+        ImPlot::PlotScatterG(label, &getRingSamplesPoint<T>, &view, getPlotCount(ringSamples.size()));
+        return;
+    }
+    if (pyramid)
+    {
+        const size_t width   = static_cast<size_t>(std::max(1.0f, ImPlot::GetPlotSize().x));
+        const size_t last    = static_cast<size_t>(first) + numElements;
+        const auto   buckets = pyramid->select(std::span<const T>(yData, last), first, last, width);
+        if (!buckets.empty())
+        {
+            ImPlot::LevelOfDetailView_t<T> view = {xData, yData, buckets};
+            ImPlot::PlotScatterG(label, &getLevelOfDetailPoint<T>, &view, getPlotCount(buckets.size()));
+            return;
+        }
+    }
+    if (!xData.values)
+    {
+        const ImPlot::XData_t x = xData.from(first);
+        ImPlot::PlotScatter(label, yData + first, numElements, x.scale, x.start, 0, offset);
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        ImPlot::PlotScatter(label, xData.values + first, yData + first, numElements, 0, offset);
+    }
+    else
+    {
+        ImPlot::SeriesView_t<T> view = {xData.from(first), yData + first, std::max(numElements, 1), offset};
+        ImPlot::PlotScatterG(label, &getSeriesPoint<T>, &view, numElements);
+    }
+}
 
-void MatlabImGuiPlot::processPlots(std::vector<ImPlot::MatlabInput_t>& info)
+template <class T>
+void MatlabImGuiPlot::plotBars(const char*            label,
+                               const ImPlot::XData_t& xData,
+                               const T*               yData,
+                               int                    first,
+                               int                    numElements,
+                               int                    offset,
+                               double                 barSize)
 {
-    for (auto& in : info)
+    const ImPlot::XData_t x = xData.from(first);
+    if (!x.values && x.scale == 1.0)
+    {
+        // ImPlot's bars without x take a start but no scale
+        ImPlot::PlotBars(label, yData + first, numElements, barSize, x.start, 0, offset);
+        return;
+    }
+    if constexpr (std::is_same_v<T, double>)
     {
-        auto subPlotDimensions = in.getSubModuleDimensions();
-        auto dataArray         = in.getMatlabPlotData();
+        if (x.values)
+        {
+            ImPlot::PlotBars(label, x.values, yData + first, numElements, barSize, 0, offset);
+            return;
+        }
+    }
+    ImPlot::SeriesView_t<T> view = {x, yData + first, std::max(numElements, 1), offset};
+    ImPlot::PlotBarsG(label, &getSeriesPoint<T>, &view, numElements, x.values ? barSize : barSize * x.scale);
+}
+
+void MatlabImGuiPlot::processPlots(const std::vector<ImPlot::MatlabInput_t>& info, bool offscreen)
+{
+    uint64_t focusedFigure = 0;
+    for (const auto& in : info)
+    {
+        const auto& subPlotDimensions = in.getSubModuleDimensions();
+
+        ImGuiWindowFlags windowFlags = 0;
+        if (offscreen)
+        {
+            ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+            ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+            windowFlags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoSavedSettings;
+        }
+
+        // Collapsed or hidden: none of the figure's subplots is prepared or submitted
+        if (!ImGui::Begin(in.getWindowTitle().c_str(), NULL, windowFlags))
+        {
+            ImGui::End();
+            continue;
+        }
+        if (ImGui::IsWindowFocused(ImGuiFocusedFlags_RootAndChildWindows))
+        {
+            focusedFigure = in.handle;
+        }
 
-        ImGui::Begin(in.getMatlabFigureNames().c_str());
+        // Moved off the viewport, which Begin does not report: the subplots are skipped as well
+        const ImVec2         windowMin = ImGui::GetWindowPos();
+        const ImVec2         windowMax = windowMin + ImGui::GetWindowSize();
+        const ImGuiViewport* viewport  = ImGui::GetMainViewport();
+        if (windowMax.x <= viewport->Pos.x || windowMax.y <= viewport->Pos.y ||
+            windowMin.x >= viewport->Pos.x + viewport->Size.x || windowMin.y >= viewport->Pos.y + viewport->Size.y)
+        {
+            ImGui::End();
+            continue;
+        }
 
         static ImPlotShadedFlags flags                = 0;
         static float             barSize              = 0.25f;
-        static float             markerSize           = 1.0f;
         static float             uncertaintyIntensity = 0.25f;
 
         if (ImPlot::BeginSubplots("##ItemSharing", subPlotDimensions[0], subPlotDimensions[1], ImVec2(-1, -1), flags))
         {
-            for (auto& data : dataArray)
+            const auto& plotData = in.getMatlabPlotData();
+            for (size_t subplot = ImPlot::Dimension_e::ZERO; subplot < plotData.size(); subplot++)
             {
-
-                errorCheck(data);
-
-                double minData1Elem = DBL_MAX;
-                double maxData1Elem = DBL_TRUE_MIN;
-                MatlabImGuiPlot::getDataMinMax<double>(data.getData1(), minData1Elem, maxData1Elem);
-
-                double minData2Elem = DBL_MAX;
-                double maxData2Elem = DBL_TRUE_MIN;
-                MatlabImGuiPlot::getDataMinMax<double>(data.getData2(), minData2Elem, maxData2Elem);
-
-                size_t dimensions  = data.getData1().size();
-                size_t numElements = data.getData1().at(ImPlot::Dimension_e::ZERO).size();
+                const auto& data     = plotData[subplot];
+                const auto& plotInfo = data.getPlotInfo();
 
                 /// title selection
-                std::string internalTitle = {};
-                internalTitle             = (data.getTitle().size() > ImPlot::Dimension_e::ZERO)
-                                                ? data.getTitle().at(ImPlot::Dimension_e::ZERO)
+                const char* internalTitle = (data.getTitle().size() > ImPlot::Dimension_e::ZERO)
+                                                ? data.getTitle()[ImPlot::Dimension_e::ZERO].c_str()
                                                 : "Figure";
 
-                if (ImPlot::BeginPlot(internalTitle.c_str()))
+                if (ImPlot::BeginPlot(internalTitle))
                 {
+                    // streamed subplots draw their ring buffers instead of the data they were created with
+                    const ImPlot::StreamData_t* stream = findStream(in.handle, subplot);
+
+                    // bounds are cached at ingest, and per append for streams
+                    const ImPlot::Bounds_t xBounds = stream ? stream->xBounds : data.getXBounds();
+                    const ImPlot::Bounds_t yBounds = stream ? stream->yBounds : data.getData2().totalBounds();
+
+                    size_t dimensions = stream ? stream->series.size() : data.getData2().size();
+
                     ImPlot::SetupLegend(ImPlotLocation_South, ImPlotLegendFlags_Outside | ImPlotLegendFlags_Horizontal);
 
                     // label selections
-                    if (data.plotInfo.labelsAvailable)
+                    if (plotInfo.labelsAvailable)
                     {
                         ImPlot::SetupAxes(data.getLabels()[ImPlot::Dimension_e::ZERO].c_str(),
                                           data.getLabels()[ImPlot::Dimension_e::ONE].c_str());
                     }
 
                     // set the axis limits
-                    if (data.plotInfo.limitsAvailable)
+                    if (plotInfo.limitsAvailable)
                     {
                         ImPlot::SetupAxesLimits(
                             data.getLimits().at(ImPlot::Dimension_e::ZERO),
                             data.getLimits().at(ImPlot::Dimension_e::ONE),
                             data.getLimits().at(ImPlot::Dimension_e::TWO),
-                            data.getLimits().at(ImPlot::Dimension_e::ONE + ImPlot::Dimension_e::TWO));
+                            data.getLimits().at(ImPlot::Dimension_e::ONE + ImPlot::Dimension_e::TWO),
+                            offscreen ? ImPlotCond_Always : ImPlotCond_Once);
                     }
-                    else
+                    else if (xBounds.valid() && yBounds.valid())
                     {
-                        ImPlot::SetupAxesLimits(minData1Elem, maxData1Elem, minData2Elem, maxData2Elem);
+                        // live data is followed, static data is only fitted once
+                        ImPlot::SetupAxesLimits(xBounds.min,
+                                                xBounds.max,
+                                                yBounds.min,
+                                                yBounds.max,
+                                                stream || offscreen ? ImPlotCond_Always : ImPlotCond_Once);
                     }
 
-                    for (size_t index = ImPlot::Dimension_e::ZERO; index < dimensions; index++)
+                    // Only the samples in view, or their LTTB samples, are submitted below, so a fit (double-click,
+                    // first frame) is extended with the cached bounds of every sample, shaded bounds included
+                    ImPlot::SetupFinish();
+                    ImPlotPlot& plot = *ImPlot::GetCurrentPlot();
+                    if (plot.FitThisFrame)
                     {
-
-                        // style
-                        if (data.plotInfo.markerSizeAvailable)
+                        ImPlot::Bounds_t fitBounds = yBounds;
+                        if (!stream)
                         {
-                            markerSize = data.getMarkerSize().at(index);
+                            fitBounds.merge(data.getUncertaintyLowerBound().totalBounds);
+                            fitBounds.merge(data.getUncertaintyUpperBound().totalBounds);
                         }
-                        ImPlot::PushStyleVar(ImPlotStyleVar_MarkerSize, markerSize);
-
-                        double xData[SHRT_MAX];
-                        double yData[SHRT_MAX];
-                        copyVector<double>(data.getData1().at(index), xData);
-                        copyVector<double>(data.getData2().at(index), yData);
+                        if (xBounds.valid() && fitBounds.valid())
+                        {
+                            ImPlotAxis& xAxis = plot.Axes[plot.CurrentX];
+                            ImPlotAxis& yAxis = plot.Axes[plot.CurrentY];
+                            xAxis.ExtendFitWith(yAxis, xBounds.min, fitBounds.min);
+                            xAxis.ExtendFitWith(yAxis, xBounds.max, fitBounds.max);
+                            yAxis.ExtendFitWith(xAxis, fitBounds.min, xBounds.min);
+                            yAxis.ExtendFitWith(xAxis, fitBounds.max, xBounds.max);
+                        }
+                    }
 
-                        double yUpperBoundUncertainty[SHRT_MAX];
-                        double yLowerBoundUncertainty[SHRT_MAX];
+                    // BeginPlot is true for a subplot scrolled out of view too, its series are only submitted when
+                    // part of the plot area can be seen
+                    const ImVec2 plotMin     = ImPlot::GetPlotPos();
+                    const bool   visible     = ImGui::IsRectVisible(plotMin, plotMin + ImPlot::GetPlotSize());
+                    const auto&  commands    = data.getDrawCommands();
+                    const size_t numCommands = visible ? std::min(dimensions, commands.size()) : 0;
+                    for (size_t index = ImPlot::Dimension_e::ZERO; index < numCommands; index++)
+                    {
+                        const auto& command = commands[index];
 
-                        if (data.plotInfo.uncertaintyLowerBoundAvailable &&
-                            data.plotInfo.uncertaintyUpperBoundAvailable)
+                        // plot straight from the stored series, no per-frame copy, y in its own type
+                        ImPlot::XData_t                xData       = command.x;
+                        ImPlot::SeriesSpan_t           ySeries     = command.y;
+                        int                            first       = 0;
+                        int                            numElements = getPlotCount(command.size());
+                        int                            offset      = 0;
+                        const ImPlot::MinMaxPyramid_t* pyramid     = command.pyramid;
+                        std::span<const size_t>        ringSamples;
+                        if (stream)
                         {
-                            copyVector<double>(data.getUncertaintyLowerBound().at(index), yLowerBoundUncertainty);
-                            copyVector<double>(data.getUncertaintyUpperBound().at(index), yUpperBoundUncertainty);
+                            // a long ring is drawn from its block min/max, two samples per pixel column at most
+                            const size_t width = static_cast<size_t>(std::max(1.0f, ImPlot::GetPlotSize().x));
+                            std::visit(
+                                [&](const auto& ring)
+                                {
+                                    xData       = ImPlot::XData_t{ring.x()};
+                                    ySeries     = std::span(ring.y(), ring.capacity());
+                                    numElements = getPlotCount(ring.size());
+                                    offset      = getPlotCount(ring.offset());
+                                    ringSamples = ring.select(width);
+                                },
+                                stream->series[index]);
+                            pyramid = NULL;
                         }
-
-                        std::string internalLegend = {};
-                        if (data.plotInfo.legendsAvailable)
+                        else if (command.monotonicX)
                         {
-                            internalLegend =
-                                (data.getLegends().size() > ImPlot::Dimension_e::ZERO) ? data.getLegends()[index] : " ";
+                            // zoomed in, only the samples in view are submitted
+                            const auto [visibleFirst, visibleCount] =
+                                getVisibleRange(command.x, numElements, ImPlot::GetPlotLimits().X);
+                            first       = getPlotCount(visibleFirst);
+                            numElements = getPlotCount(visibleCount);
                         }
 
-                        
-                        if (data.plotInfo.plotTypesAvailable)
+                        // uncertainty bounds are drawn against the samples in view, decimated or not
+                        const int boundsFirst = first;
+                        const int boundsCount = numElements;
+
+                        // LTTB samples once they are ready, every sample until then
+                        if (!stream && !offscreen && command.decimation == ImPlot::Decimation_e::LTTB)
                         {
-                            // Line plots
-                            if (data.getPlotTypes()[index].compare("Line") == 0)
+                            if (const auto* decimated = decimate(in.handle, subplot, index, data))
                             {
-                                if (data.plotInfo.colorsAvailable)
-                                {
-                                    ImPlot::PushStyleColor(ImPlotCol_Line, data.getColors().at(index));
-                                }
-                                if (data.plotInfo.markerShapesAvailable)
-                                {
-                                    ImPlot::SetNextMarkerStyle(data.getMarkerShapes().at(index));
-                                }
-                                ImPlot::PlotLine(internalLegend.c_str(), xData, yData, numElements);
-                                if (data.plotInfo.colorsAvailable)
-                                {
-                                    ImPlot::PopStyleColor();
-                                }
+                                xData       = ImPlot::XData_t{decimated->x.data()};
+                                ySeries     = std::span<const double>(decimated->y);
+                                first       = 0;
+                                numElements = getPlotCount(decimated->x.size());
                             }
+                        }
 
-                            /// Bar plots
-                            if (data.getPlotTypes()[index].compare("Bars") == 0)
-                            {
-                                if (data.plotInfo.colorsAvailable)
-                                {
-                                    ImPlot::PushStyleColor(ImPlotCol_Fill, data.getColors().at(index));
-                                }
-
-                                ImPlot::PlotBars(internalLegend.c_str(), xData, yData, numElements, barSize);
-
-                                if (data.plotInfo.colorsAvailable)
-                                {
-                                    ImPlot::PopStyleColor();
-                                }
-                            }
+                        // style
+                        ImPlot::PushStyleVar(ImPlotStyleVar_MarkerSize, command.markerSize);
+                        if (command.lineWidthAvailable)
+                        {
+                            ImPlot::PushStyleVar(ImPlotStyleVar_LineWeight, command.lineWidth);
+                        }
+                        if (command.colorAvailable)
+                        {
+                            ImPlot::PushStyleColor(command.type == ImPlot::PlotType_e::LINE ? ImPlotCol_Line
+                                                                                            : ImPlotCol_Fill,
+                                                   command.color);
+                        }
+                        if (command.markerAvailable && command.type != ImPlot::PlotType_e::BARS)
+                        {
+                            ImPlot::SetNextMarkerStyle(command.marker);
+                        }
 
-                            /// Scatter plots
-                            if (data.getPlotTypes()[index].compare("Scatter") == 0)
+                        const char* internalLegend = command.legend.c_str();
+                        std::visit(
+                            [&](auto yData)
                             {
-                                if (data.plotInfo.colorsAvailable)
-                                {
-                                    ImPlot::PushStyleColor(ImPlotCol_Fill, data.getColors().at(index));
-                                }
-                                if (data.plotInfo.markerShapesAvailable)
-                                {
-                                    ImPlot::SetNextMarkerStyle(data.getMarkerShapes().at(index));
-                                }
-                                ImPlot::PlotScatter(internalLegend.c_str(), xData, yData, numElements);
-                                if (data.plotInfo.colorsAvailable)
+                                switch (command.type)
                                 {
-                                    ImPlot::PopStyleColor();
+                                case ImPlot::PlotType_e::LINE:
+                                    plotLine(internalLegend,
+                                             xData,
+                                             yData.data(),
+                                             first,
+                                             numElements,
+                                             offset,
+                                             pyramid,
+                                             ringSamples);
+                                    break;
+                                case ImPlot::PlotType_e::SCATTER:
+                                    plotScatter(internalLegend,
+                                                xData,
+                                                yData.data(),
+                                                first,
+                                                numElements,
+                                                offset,
+                                                pyramid,
+                                                ringSamples);
+                                    break;
+                                case ImPlot::PlotType_e::BARS:
+                                    plotBars(internalLegend, xData, yData.data(), first, numElements, offset, barSize);
+                                    break;
                                 }
-                            }
+                            },
+                            ySeries);
+
+                        if (command.colorAvailable)
+                        {
+                            ImPlot::PopStyleColor();
                         }
-                        else
+
+                        /// If uncertainty info, not streamed so only drawn with the data it was given with
+                        if (!stream && command.shaded)
                         {
-                            if (data.plotInfo.colorsAvailable)
-                            {
-                                ImPlot::PushStyleColor(ImPlotCol_Line, data.getColors().at(index));
-                            }
-                            if (data.plotInfo.markerShapesAvailable)
+                            ImPlot::PushStyleVar(ImPlotStyleVar_FillAlpha, uncertaintyIntensity);
+                            if (command.colorAvailable)
                             {
-                                ImPlot::SetNextMarkerStyle(data.getMarkerShapes().at(index));
+                                ImPlot::PushStyleColor(ImPlotCol_Fill, command.color);
                             }
-                            ImPlot::PlotLine(internalLegend.c_str(), xData, yData, numElements);
-                            if (data.plotInfo.colorsAvailable)
+                            const int numBounds = getPlotCount(std::min(command.lower.size(), command.upper.size()));
+                            const int numShaded = std::max(0, std::min(boundsCount, numBounds - boundsFirst));
+                            if (command.x.values)
                             {
-                                ImPlot::PopStyleColor();
+                                ImPlot::PlotShaded(internalLegend,
+                                                   command.x.values + boundsFirst,
+                                                   command.upper.data() + boundsFirst,
+                                                   command.lower.data() + boundsFirst,
+                                                   numShaded);
                             }
-                        }
-
-                        /// If uncertainty info
-                        if (data.plotInfo.uncertaintyLowerBoundAvailable &&
-                            data.plotInfo.uncertaintyUpperBoundAvailable)
-                        {
-                            ImPlot::PushStyleVar(ImPlotStyleVar_FillAlpha, uncertaintyIntensity);
-                            if (data.plotInfo.colorsAvailable)
+                            else
                             {
-                                ImPlot::PushStyleColor(ImPlotCol_Fill, data.getColors().at(index));
+                                const auto                   x     = command.x.from(boundsFirst);
+                                ImPlot::SeriesView_t<double> upper = {
+                                    x, command.upper.data() + boundsFirst, std::max(numShaded, 1), 0};
+                                ImPlot::SeriesView_t<double> lower = {
+                                    x, command.lower.data() + boundsFirst, std::max(numShaded, 1), 0};
+                                ImPlot::PlotShadedG(internalLegend,
+                                                    &getSeriesPoint<double>,
+                                                    &upper,
+                                                    &getSeriesPoint<double>,
+                                                    &lower,
+                                                    numShaded);
                             }
-                            ImPlot::PlotShaded(internalLegend.c_str(),
-                                               xData,
-                                               yUpperBoundUncertainty,
-                                               yLowerBoundUncertainty,
-                                               numElements);
-                            if (data.plotInfo.colorsAvailable)
+                            if (command.colorAvailable)
                             {
                                 ImPlot::PopStyleColor();
                             }
                             ImPlot::PopStyleVar();
                         }
+                        ImPlot::PopStyleVar(command.lineWidthAvailable ? 2 : 1);
                     }
                     ImPlot::EndPlot();
                 }
@@ -375,4 +1232,8 @@ void MatlabImGuiPlot::processPlots(std::vector<ImPlot::MatlabInput_t>& info)
         }
         ImGui::End();
     }
+    if (!offscreen)
+    {
+        mFocusedFigure = focusedFigure;
+    }
 }
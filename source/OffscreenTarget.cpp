@@ -0,0 +1,89 @@
+#include "OffscreenTarget.h"
+
+#include <algorithm>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+namespace ImPlot
+{
+OffscreenTarget_t::~OffscreenTarget_t()
+{
+    release();
+}
+
+bool OffscreenTarget_t::bind(int width, int height)
+{
+    if (mFramebuffer != 0 && (width != mWidth || height != mHeight))
+    {
+        release();
+    }
+
+    if (mFramebuffer == 0)
+    {
+        glGenFramebuffers(1, &mFramebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+        glGenRenderbuffers(1, &mColor);
+        glBindRenderbuffer(GL_RENDERBUFFER, mColor);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, mColor);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        mWidth  = width;
+        mHeight = height;
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            release();
+            return false;
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+    glViewport(0, 0, mWidth, mHeight);
+    return true;
+}
+
+void OffscreenTarget_t::unbind()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+std::vector<unsigned char> OffscreenTarget_t::readPixels() const
+{
+    const size_t               stride = static_cast<size_t>(mWidth) * 4;
+    std::vector<unsigned char> pixels(stride * mHeight);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, mWidth, mHeight, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+    // OpenGL reads bottom row first
+    std::vector<unsigned char> row(stride);
+    for (int top = 0, bottom = mHeight - 1; top < bottom; top++, bottom--)
+    {
+        std::copy_n(pixels.begin() + top * stride, stride, row.begin());
+        std::copy_n(pixels.begin() + bottom * stride, stride, pixels.begin() + top * stride);
+        std::copy_n(row.begin(), stride, pixels.begin() + bottom * stride);
+    }
+    return pixels;
+}
+
+void OffscreenTarget_t::release()
+{
+    if (mFramebuffer != 0)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &mFramebuffer);
+        glDeleteRenderbuffers(1, &mColor);
+    }
+    mFramebuffer = 0;
+    mColor       = 0;
+    mWidth       = 0;
+    mHeight      = 0;
+}
+
+bool OffscreenTarget_t::writePng(const std::string&                fileName,
+                                 int                               width,
+                                 int                               height,
+                                 const std::vector<unsigned char>& pixels)
+{
+    return stbi_write_png(fileName.c_str(), width, height, 4, pixels.data(), width * 4) != 0;
+}
+} // namespace ImPlot
@@ -15,62 +15,105 @@ class MexFunction : public matlab::mex::Function
     /// Factory helper for creating Matlab arrays
     matlab::data::ArrayFactory mFactory;
 
-    /// Declaring variables
-    std::array<size_t, 2U> mDataDimension;
-    size_t                 mColumnDimension;
-
     /// type def
     typedef matlab::mex::ArgumentList                            mArgument_t;
-    typedef std::map<std::string, ImVec4>                        mImVec4_t;
-    typedef std::map<std::array<std::string, 2U>, ImPlotMarker_> mMarkerType_t;
     typedef matlab::data::TypedArray<matlab::data::MATLABString> mString_t;
     typedef std::vector<std::string>                             mVecString_t;
+    typedef std::vector<size_t>                                  mFieldLayout_t; // field kind per struct field
 
-    /// Populate unique numbers
-    template <class T>
-    struct UniqueNumber_t
-    {
-        T current;
-        UniqueNumber_t()
-        {
-            current = 0;
-        }
-        T operator()()
+    /// Field kinds: the optional fields by their Miscellaneous_e value, then the samples
+    static constexpr size_t DATA1_FIELD       = MatlabImGuiPlot::INPUT_VARIABLE_NAMES.size();
+    static constexpr size_t DATA2_FIELD       = DATA1_FIELD + 1;
+    static constexpr size_t UNKNOWN_FIELD     = SIZE_MAX;
+    static constexpr size_t MAX_FIELD_LAYOUTS = 64;
+
+    /// Field kind by name, case-insensitive
+    static constexpr ImPlot::NameIndex_t<64, true> FIELD_INDEX = ImPlot::NameIndex_t<64, true>(
+        []()
         {
-            return ++current;
-        }
-    };
+            std::array<std::string_view, DATA2_FIELD + 1> names = {};
+            std::copy(MatlabImGuiPlot::INPUT_VARIABLE_NAMES.begin(),
+                      MatlabImGuiPlot::INPUT_VARIABLE_NAMES.end(),
+                      names.begin());
+            names[DATA1_FIELD] = "data1";
+            names[DATA2_FIELD] = "data2";
+            return names;
+        }());
+
+    /// Resolved field kinds by the struct's field names, in order
+    std::map<mVecString_t, mFieldLayout_t> mFieldLayouts;
+
+    /// Render thread and window, kept alive between calls
+    MatlabImGuiPlot mPlot;
+
+    /// Largest width or height of an exported image, in pixels
+    static constexpr double MAX_EXPORT_SIZE = 16384;
+
+    /// Figures on display by handle, and the ones owned by the last plain imGuiPlotMex("Name", ...) call
+    std::map<uint64_t, ImPlot::MatlabInput_t> mFigures;
+    std::vector<uint64_t>                     mLegacyHandles;
+    uint64_t                                  mNextHandle = 1;
+
+    /// Sample bytes taken in so far, added to by the ingest workers, and the wall time of the calls that took them
+    /// in, measured on this thread; reported by "stats"
+    std::atomic<uint64_t> mIngestBytes   = 0;
+    double                mIngestSeconds = 0.0;
+
+    /// Wall time of the last call's subplots, in total and each in argument order, reported by "stats"
+    double              mBatchSeconds = 0.0;
+    std::vector<double> mElementSeconds;
+
+    /// Parse and prepare the subplots of all figures of a call in parallel, started on first use
+    std::unique_ptr<ImPlot::ThreadPool_t> mIngestWorkers;
 
     /// Plot infomations
-    std::string                        mFigureConfiguration;
     std::vector<ImPlot::MatlabInput_t> mInputFromMatlab;
-    std::vector<ImPlot::PlotData_t>    mStructurePlottingInfo;
-    std::vector<double>                mSubPlotDimension;
 
     /// Handle to Matlab engine
     std::shared_ptr<matlab::engine::MATLABEngine> mMatlabPtr = getEngine();
 
     /// Helper functions
 
+    void appendSamples(mArgument_t& inputs);
+
     bool checkStructureElements(matlab::data::StructArray const& matlabStructArray);
 
+    void closeFigures(mArgument_t& inputs);
+
+    void createFigures(mArgument_t& outputs, mArgument_t& inputs);
+
     void displayError(std::string errorMessage);
 
     template <class T, class U>
     U dataFormat(T& data);
 
+    void exportFigures(mArgument_t& outputs, mArgument_t& inputs);
+
     void displayOnMATLAB(std::ostringstream& stream);
 
+    void displayStatistics();
+
     void emptyFieldInformation(std::string fieldName, size_t index);
 
+    static std::string formatFrameRate(double rate);
+
     template <class T>
     ImPlot::PlotData_t formatStructures(matlab::data::StructArray& matlabStructArray);
 
-    mImVec4_t getAvailableColorTypes() const;
+    template <class T>
+    ImPlot::PlotData_t formatStructureElement(const matlab::data::StructArray& matlabStructArray,
+                                              size_t                           element,
+                                              const mVecString_t&              fieldNames,
+                                              const mFieldLayout_t&            layout,
+                                              ImPlot::SampleViews_t&           samples);
+
+    void copySamples(const ImPlot::SampleViews_t& samples, ImPlot::PlotData_t& data);
+
+    const mFieldLayout_t& getFieldLayout(const mVecString_t& fieldNames);
 
-    mVecString_t getAvailableInputVariableNames() const;
+    std::vector<uint64_t> getHandles(const matlab::data::Array& data);
 
-    mMarkerType_t getAvailableMarkerInfo() const;
+    bool isCommand(mArgument_t& inputs, const std::string& command);
 
     template <class T, class U>
     U getColorFormat(T& data);
@@ -78,17 +121,27 @@ class MexFunction : public matlab::mex::Function
     template <class T, class U>
     U getMarkerFormat(T& inputs);
 
-    template <class T, class U, class W>
-    void inputDataExtractions(T& data, U& formattedData);
+    template <class Element_t, class Stored_t = Element_t>
+    ImPlot::MatrixView_t getMatrixView(const matlab::data::Array& data);
+
+    ImPlot::MatrixView_t getSeriesView(const matlab::data::Array& data);
 
     void invalidFieldInformation(std::string fieldName, size_t index);
 
-    template <class T>
-    void process(mArgument_t& data);
+    ImPlot::PlotData_t mergeStructures(const ImPlot::PlotData_t& current, ImPlot::PlotData_t update);
+
+    template <class T, class It>
+    void process(It first, It last);
+
+    void publishFigures();
+
+    void setFrameRate(mArgument_t& inputs);
+
+    std::vector<uint64_t> registerFigures(std::vector<ImPlot::MatlabInput_t>& figures);
 
-    void toLower(std::string& data);
+    void updateFigure(mArgument_t& inputs);
 
-    bool validateArguments(mArgument_t outputs, mArgument_t inputs);
+    bool validateArguments(mArgument_t& outputs, mArgument_t& inputs, size_t first, size_t numOutputs);
 
   public:
     /// main entry point
@@ -97,20 +150,143 @@ class MexFunction : public matlab::mex::Function
 
 void MexFunction::operator()(mArgument_t outputs, mArgument_t inputs)
 {
+    // imGuiPlotMex("stats")
+    if (isCommand(inputs, "stats"))
+    {
+        displayStatistics();
+        return;
+    }
+
+    // h = imGuiPlotMex("create", "Name", [r,c], s1, ..., sN)
+    if (isCommand(inputs, "create"))
+    {
+        createFigures(outputs, inputs);
+        return;
+    }
+
+    // imGuiPlotMex("update", h, subplot, s)
+    if (isCommand(inputs, "update"))
+    {
+        updateFigure(inputs);
+        return;
+    }
+
+    // imGuiPlotMex("append", h, subplot, s)
+    if (isCommand(inputs, "append"))
+    {
+        appendSamples(inputs);
+        return;
+    }
+
+    // imGuiPlotMex("close", h)
+    if (isCommand(inputs, "close"))
+    {
+        closeFigures(inputs);
+        return;
+    }
+
+    // imGuiPlotMex("export", h, files[, [w,h]]) or imGuiPlotMex("export", files, [w,h], "Name", [r,c], s1, ..., sN)
+    if (isCommand(inputs, "export"))
+    {
+        exportFigures(outputs, inputs);
+        return;
+    }
+
+    // imGuiPlotMex("framerate", h, fps) or imGuiPlotMex("framerate", h, fps, unfocusedFps)
+    if (isCommand(inputs, "framerate"))
+    {
+        setFrameRate(inputs);
+        return;
+    }
+
     // Check to verify the validity of the Matlabs input
-    if (validateArguments(outputs, inputs))
+    if (validateArguments(outputs, inputs, ImPlot::Dimension_e::ZERO, ImPlot::Dimension_e::ZERO))
     {
         if (inputs.size() > ImPlot::Dimension_e::ZERO)
         {
             /// Processs the input data
-            mStructurePlottingInfo = {};
-            mInputFromMatlab       = {};
-            process<double>(inputs);
-            std::shared_ptr<MatlabImGuiPlot> run(new MatlabImGuiPlot(mInputFromMatlab));
-            mStructurePlottingInfo = {};
-            mInputFromMatlab       = {};
+            mInputFromMatlab = {};
+            process<double>(inputs.begin(), inputs.end());
+
+            // A plain call replaces the figures of the previous plain call
+            auto handles = registerFigures(mInputFromMatlab);
+            for (auto handle : mLegacyHandles)
+            {
+                mFigures.erase(handle);
+            }
+            mLegacyHandles = std::move(handles);
+            publishFigures();
+
+            mInputFromMatlab = {};
+        }
+    }
+}
+
+// Send only the new samples of one subplot to its ring buffers; the figure itself is left as it is.
+void MexFunction::appendSamples(mArgument_t& inputs)
+{
+    if (inputs.size() != 4 || inputs[1].getType() != matlab::data::ArrayType::DOUBLE ||
+        inputs[2].getType() != matlab::data::ArrayType::DOUBLE ||
+        inputs[3].getType() != matlab::data::ArrayType::STRUCT)
+    {
+        displayError("Usage: imGuiPlotMex(\"append\", handle, subplot, struct).");
+        return;
+    }
+
+    const auto handles  = getHandles(inputs[1]);
+    const auto subplots = getHandles(inputs[2]);
+    auto       figure   = handles.empty() ? mFigures.end() : mFigures.find(handles[0]);
+    if (figure == mFigures.end())
+    {
+        displayError("Unknown figure handle.");
+        return;
+    }
+    if (subplots.empty() || subplots[0] == 0 || subplots[0] > figure->second.plotData.size())
+    {
+        displayError("Subplot index out of range.");
+        return;
+    }
+
+    const auto& plotData = figure->second.plotData[subplots[0] - 1];
+    if (!plotData.getPlotInfo().capacityAvailable)
+    {
+        displayError("Subplot was not created with a Capacity.");
+        return;
+    }
+
+    matlab::data::StructArray matlabStructArray = inputs[3];
+    if (!checkStructureElements(matlabStructArray))
+    {
+        return;
+    }
+
+    const auto start   = std::chrono::steady_clock::now();
+    auto       samples = formatStructures<double>(matlabStructArray);
+    mIngestSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    try
+    {
+        MatlabImGuiPlot::errorCheck(samples);
+        if (!samples.getPlotInfo().data1Available || samples.getData2().size() != plotData.getData2().size())
+        {
+            throw std::invalid_argument("Appended data and subplot dimensions are not equal");
         }
+        // a lone data1 is x for an update of an explicit-x subplot, so it is not taken as y here either
+        if (samples.getPlotInfo().implicitX && !plotData.getPlotInfo().implicitX)
+        {
+            throw std::invalid_argument("Subplot has explicit x, append both data1 (x) and data2 (y)");
+        }
+    }
+    catch (const std::invalid_argument& error)
+    {
+        displayError(error.what());
+        return;
     }
+
+    mPlot.append({figure->first,
+                  subplots[0] - 1,
+                  std::move(samples.data1),
+                  std::move(samples.data2),
+                  samples.getPlotInfo().implicitX});
 }
 
 // Make sure that the passed structure has valid data.
@@ -132,13 +308,176 @@ bool MexFunction::checkStructureElements(matlab::data::StructArray const& matlab
     return status;
 }
 
+// Remove figures by handle; their buffers are released once the render thread lets go.
+void MexFunction::closeFigures(mArgument_t& inputs)
+{
+    if (inputs.size() != ImPlot::Dimension_e::TWO || inputs[1].getType() != matlab::data::ArrayType::DOUBLE)
+    {
+        displayError("Usage: imGuiPlotMex(\"close\", handles).");
+        return;
+    }
+
+    for (auto handle : getHandles(inputs[1]))
+    {
+        mFigures.erase(handle);
+    }
+    publishFigures();
+}
+
+// Pace figures to a frame rate, and to a lower one while they do not have focus.
+void MexFunction::setFrameRate(mArgument_t& inputs)
+{
+    if ((inputs.size() != 3 && inputs.size() != 4) || inputs[1].getType() != matlab::data::ArrayType::DOUBLE ||
+        inputs[2].getType() != matlab::data::ArrayType::DOUBLE ||
+        (inputs.size() == 4 && inputs[3].getType() != matlab::data::ArrayType::DOUBLE))
+    {
+        displayError("Usage: imGuiPlotMex(\"framerate\", handles, fps[, unfocusedFps]).");
+        return;
+    }
+
+    ImPlot::FrameRate_t frameRate;
+    for (size_t index = 2; index < inputs.size(); index++)
+    {
+        matlab::data::TypedArray<double> internalInput = inputs[index];
+        auto values = dataFormat<matlab::data::TypedArray<double>, std::vector<double>>(internalInput);
+        if (values.size() != ImPlot::Dimension_e::ONE || !(values[0] >= 0.0))
+        {
+            displayError("Frame rates should be single values, 0 for vsync or Inf for uncapped.");
+            return;
+        }
+        frameRate.unfocused = values[0];
+        frameRate.focused   = index == 2 ? values[0] : frameRate.focused;
+    }
+
+    const auto handles = getHandles(inputs[1]);
+    for (auto handle : handles)
+    {
+        if (mFigures.find(handle) == mFigures.end())
+        {
+            displayError("Unknown figure handle.");
+            return;
+        }
+    }
+    for (auto handle : handles)
+    {
+        mFigures[handle].frameRate = frameRate;
+    }
+    publishFigures();
+}
+
+// Parse figures like a plain call and return one handle per figure.
+void MexFunction::createFigures(mArgument_t& outputs, mArgument_t& inputs)
+{
+    if (validateArguments(outputs, inputs, ImPlot::Dimension_e::ONE, ImPlot::Dimension_e::ONE))
+    {
+        mInputFromMatlab = {};
+        process<double>(inputs.begin() + 1, inputs.end());
+
+        auto                handles = registerFigures(mInputFromMatlab);
+        std::vector<double> values(handles.begin(), handles.end());
+        publishFigures();
+
+        if (outputs.size() > ImPlot::Dimension_e::ZERO)
+        {
+            outputs[0] =
+                mFactory.createArray<double>({1, values.size()}, values.data(), values.data() + values.size());
+        }
+
+        mInputFromMatlab = {};
+    }
+}
+
 template <class T, class U>
 U MexFunction::dataFormat(T& data)
 {
-    T object(data);
+    // const access: a non-const iterator makes MATLAB unshare (deep copy) the array first
+    const T object(data);
     return U(object.begin(), object.end());
 }
 
+// Write figures to PNG files without showing them: figures already created, or ones given as to "create".
+void MexFunction::exportFigures(mArgument_t& outputs, mArgument_t& inputs)
+{
+    // handles, files and an optional size, or files, a size and figures
+    const bool   byHandle   = inputs.size() > ImPlot::Dimension_e::ONE &&
+                           inputs[1].getType() == matlab::data::ArrayType::DOUBLE;
+    const size_t filesIndex = byHandle ? 2 : 1;
+    const size_t sizeIndex  = filesIndex + 1;
+    const bool   hasFiles   = inputs.size() > filesIndex &&
+                           inputs[filesIndex].getType() == matlab::data::ArrayType::MATLAB_STRING;
+    const bool hasSize = inputs.size() > sizeIndex && inputs[sizeIndex].getType() == matlab::data::ArrayType::DOUBLE;
+
+    // the size may be left out after handles, figures must follow it
+    const bool validSize =
+        byHandle ? inputs.size() == sizeIndex || (hasSize && inputs.size() == sizeIndex + 1) : hasSize;
+    if (!hasFiles || !validSize)
+    {
+        displayError("Usage: imGuiPlotMex(\"export\", handles, files[, [width, height]]) or "
+                     "imGuiPlotMex(\"export\", files, [width, height], \"Name\", [r,c], s1, ..., sN).");
+        return;
+    }
+
+    mString_t files     = inputs[filesIndex];
+    auto      fileNames = dataFormat<mString_t, mVecString_t>(files);
+
+    ImPlot::ExportJob_t defaults;
+    if (hasSize)
+    {
+        matlab::data::TypedArray<double> internalInput = inputs[sizeIndex];
+        auto size = dataFormat<matlab::data::TypedArray<double>, std::vector<double>>(internalInput);
+        if (size.size() != ImPlot::Dimension_e::TWO || !(size[0] >= 1 && size[0] <= MAX_EXPORT_SIZE) ||
+            !(size[1] >= 1 && size[1] <= MAX_EXPORT_SIZE))
+        {
+            displayError("Image size should be [width, height] in pixels, at most " + std::to_string(MAX_EXPORT_SIZE) +
+                         " each.");
+            return;
+        }
+        defaults.width  = static_cast<int>(size[0]);
+        defaults.height = static_cast<int>(size[1]);
+    }
+
+    std::vector<ImPlot::MatlabInput_t> figures;
+    if (byHandle)
+    {
+        for (auto handle : getHandles(inputs[1]))
+        {
+            auto figure = mFigures.find(handle);
+            if (figure == mFigures.end())
+            {
+                displayError("Unknown figure handle.");
+                return;
+            }
+            figures.push_back(figure->second);
+        }
+    }
+    else if (validateArguments(outputs, inputs, sizeIndex + 1, ImPlot::Dimension_e::ZERO))
+    {
+        mInputFromMatlab = {};
+        process<double>(inputs.begin() + sizeIndex + 1, inputs.end());
+        figures          = std::move(mInputFromMatlab);
+        mInputFromMatlab = {};
+    }
+    if (figures.empty() || figures.size() != fileNames.size())
+    {
+        displayError("Exports need one file name per figure.");
+        return;
+    }
+
+    std::vector<ImPlot::ExportJob_t> jobs;
+    for (size_t index = 0; index < figures.size(); index++)
+    {
+        jobs.push_back({std::move(figures[index]), fileNames[index], defaults.width, defaults.height});
+    }
+    try
+    {
+        mPlot.exportFigures(std::move(jobs));
+    }
+    catch (const std::exception& error)
+    {
+        displayError(error.what());
+    }
+}
+
 // Helper function to generate an error message from given string,
 // and display it over MATLAB command prompt.
 
@@ -154,6 +493,46 @@ void MexFunction::displayOnMATLAB(std::ostringstream& stream)
     stream.str(""); /// Clear stream buffer
 }
 
+// Report resource usage of the persistent plot window.
+void MexFunction::displayStatistics()
+{
+    std::ostringstream stream;
+    const auto         memory = ImGuiContextManager::getMemoryUsage();
+    stream << "ImGui/ImPlot context memory: " << memory.bytes << " bytes in " << memory.allocations
+           << " allocations" << std::endl;
+    const uint64_t bytes   = mIngestBytes;
+    const double   seconds = mIngestSeconds;
+    stream << "Ingest: " << bytes << " bytes in " << seconds << " s wall ("
+           << (seconds > 0.0 ? bytes / seconds / 1e9 : 0.0) << " GB/s)" << std::endl;
+    const auto frames = mPlot.getFrameStats();
+    stream << "Frames: target " << formatFrameRate(frames.target) << ", last " << frames.frames << " back to back "
+           << (frames.meanInterval > 0.0 ? 1.0 / frames.meanInterval : 0.0) << " fps, interval mean "
+           << frames.meanInterval * 1e3 << " ms, p99 " << frames.p99Interval * 1e3 << " ms, max "
+           << frames.maxInterval * 1e3 << " ms, work " << frames.meanWork * 1e3 << " ms" << std::endl;
+    for (const auto& [handle, figure] : mFigures)
+    {
+        stream << "  figure " << handle << " \"" << figure.figureConfig << "\": "
+               << formatFrameRate(figure.frameRate.focused) << " focused, "
+               << formatFrameRate(figure.frameRate.unfocused) << " unfocused" << std::endl;
+    }
+    stream << "Last call: " << mElementSeconds.size() << " subplots in " << mBatchSeconds << " s wall" << std::endl;
+    for (size_t subplot = 0; subplot < mElementSeconds.size(); subplot++)
+    {
+        stream << "  subplot " << subplot + 1 << ": " << mElementSeconds[subplot] * 1e3 << " ms" << std::endl;
+    }
+    displayOnMATLAB(stream);
+}
+
+// Frame rate as given to "framerate": 0 is vsync, infinity uncapped.
+std::string MexFunction::formatFrameRate(double rate)
+{
+    if (rate == 0.0)
+    {
+        return "vsync";
+    }
+    return std::isinf(rate) ? "uncapped" : std::to_string(rate) + " fps";
+}
+
 // Helper function to information about an empty field in the structure.
 void MexFunction::emptyFieldInformation(std::string fieldName, size_t index)
 {
@@ -163,190 +542,236 @@ void MexFunction::emptyFieldInformation(std::string fieldName, size_t index)
     displayOnMATLAB(stream);
 }
 
+// First element of a struct, for the calls that take one subplot.
 template <class T>
 ImPlot::PlotData_t MexFunction::formatStructures(matlab::data::StructArray& matlabStructArray)
 {
-    ImPlot::PlotData_t plottingInfo            = {};
-    size_t             miscellaneousIndexStart = ImPlot::Dimension_e::ONE;
-    auto               inputTypes              = getAvailableInputVariableNames();
-    for (auto& type : inputTypes)
+    if (matlabStructArray.getType() != matlab::data::ArrayType::STRUCT)
     {
-        toLower(type);
+        return {};
     }
 
-    if (matlabStructArray.getType() == matlab::data::ArrayType::STRUCT)
+    auto         fields = matlabStructArray.getFieldNames();
+    mVecString_t fieldNames(fields.begin(), fields.end());
+    try
     {
-        size_t total_num_of_elements = matlabStructArray.getNumberOfElements();
-        auto   fields                = matlabStructArray.getFieldNames();
-
-        // Content of each structure
-        mVecString_t fieldNames(fields.begin(), fields.end());
+        ImPlot::SampleViews_t samples;
+        auto                  plottingInfo =
+            formatStructureElement<T>(matlabStructArray, 0, fieldNames, getFieldLayout(fieldNames), samples);
+        copySamples(samples, plottingInfo);
+        return plottingInfo;
+    }
+    catch (const std::invalid_argument& error)
+    {
+        displayError(error.what());
+        return {};
+    }
+}
 
-        if (fieldNames.size() > 0 && fieldNames[0].compare("data1") == ImPlot::Dimension_e::ZERO)
+// One element of a struct, on the MEX thread like every MATLAB array access. The samples are only viewed in
+// MATLAB's buffers, copySamples then copies them on any thread.
+template <class T>
+ImPlot::PlotData_t MexFunction::formatStructureElement(const matlab::data::StructArray& matlabStructArray,
+                                                       size_t                           element,
+                                                       const mVecString_t&              fieldNames,
+                                                       const mFieldLayout_t&            layout,
+                                                       ImPlot::SampleViews_t&           samples)
+{
+    ImPlot::PlotData_t plottingInfo = {};
+    for (size_t index = 0; index < fieldNames.size(); index++)
+    {
+        if (layout[index] == UNKNOWN_FIELD)
         {
-            matlab::data::TypedArray<T> structField = matlabStructArray[0][fieldNames[0]];
-            mDataDimension   = {structField.getDimensions().at(0), structField.getDimensions().at(1)};
-            mColumnDimension = mDataDimension[ImPlot::Dimension_e::ONE];
+            continue;
+        }
 
-            inputDataExtractions<matlab::data::TypedArray<T>, std::vector<std::vector<T>>, std::vector<T>>(
-                structField, plottingInfo.data1);
+        const matlab::data::Array structField = matlabStructArray[element][fieldNames[index]];
+        switch (layout[index])
+        {
+        // x-data, or y-data if there is no data2
+        case DATA1_FIELD:
+        {
+            samples.data1                        = getSeriesView(structField);
+            plottingInfo.plotInfo.data1Available = true;
             plottingInfo.plotInfo.onlyStructures = true;
+            break;
         }
 
-        if (fieldNames.size() > 1)
+        // y-data if there are any.
+        case DATA2_FIELD:
         {
-            for (auto str : fieldNames)
-            {
-                const auto internalStr = str;
-                toLower(str);
-
-                // y-data if there are any.
-                if (str.compare("data2") == ImPlot::Dimension_e::ZERO)
-                {
-                    matlab::data::TypedArray<T> structField = matlabStructArray[0][internalStr];
-                    inputDataExtractions<matlab::data::TypedArray<T>, std::vector<std::vector<T>>, std::vector<T>>(
-                        structField, plottingInfo.data2);
-                    miscellaneousIndexStart = ImPlot::Dimension_e::TWO;
-                }
-
-                // PlotTypes
-                if (inputTypes[ImPlot::Miscellaneous_e::PLOT_TYPES].compare(str) == ImPlot::Dimension_e::ZERO)
-                {
-                    mString_t internalInput                  = matlabStructArray[0][internalStr];
-                    plottingInfo.plotTypes                   = dataFormat<mString_t, mVecString_t>(internalInput);
-                    plottingInfo.plotInfo.plotTypesAvailable = true;
-                }
-
-                // MarkerShapes
-                if (inputTypes[ImPlot::Miscellaneous_e::MARKER_SHAPES].compare(str) == ImPlot::Dimension_e::ZERO)
-                {
-                    mString_t internalInput   = matlabStructArray[0][internalStr];
-                    plottingInfo.markerShapes = getMarkerFormat<mString_t, std::vector<ImPlotMarker_>>(internalInput);
-                    plottingInfo.plotInfo.markerShapesAvailable = true;
-                }
-
-                // Colors
-                if (inputTypes[ImPlot::Miscellaneous_e::COLORS].compare(str) == ImPlot::Dimension_e::ZERO)
-                {
-                    mString_t internalInput = matlabStructArray[0][internalStr];
-                    plottingInfo.colors     = getColorFormat<mString_t, std::vector<ImVec4>>(internalInput);
-                    plottingInfo.plotInfo.colorsAvailable = true;
-                }
-                // LineWidths
-                if (inputTypes[ImPlot::Miscellaneous_e::LINE_WIDTHS].compare(str) == ImPlot::Dimension_e::ZERO)
-                {
-                    matlab::data::TypedArray<T> internalInput = matlabStructArray[0][internalStr];
-                    plottingInfo.lineWidth = dataFormat<matlab::data::TypedArray<T>, std::vector<T>>(internalInput);
-                    plottingInfo.plotInfo.lineWidthAvailable = true;
-                }
-
-                // MarkerSizes
-                if (inputTypes[ImPlot::Miscellaneous_e::MARKER_SIZES].compare(str) == ImPlot::Dimension_e::ZERO)
-                {
-                    matlab::data::TypedArray<T> internalInput = matlabStructArray[0][internalStr];
-                    plottingInfo.markerSize = dataFormat<matlab::data::TypedArray<T>, std::vector<T>>(internalInput);
-                    plottingInfo.plotInfo.markerSizeAvailable = true;
-                }
-
-                // Title
-                if (inputTypes[ImPlot::Miscellaneous_e::TITLE].compare(str) == ImPlot::Dimension_e::ZERO)
-                {
-                    mString_t internalInput              = matlabStructArray[0][internalStr];
-                    plottingInfo.title                   = dataFormat<mString_t, mVecString_t>(internalInput);
-                    plottingInfo.plotInfo.titleAvailable = true;
-                }
-                // Labels
-                if (inputTypes[ImPlot::Miscellaneous_e::LABELS].compare(str) == ImPlot::Dimension_e::ZERO)
-                {
-                    mString_t internalInput               = matlabStructArray[0][internalStr];
-                    plottingInfo.labels                   = dataFormat<mString_t, mVecString_t>(internalInput);
-                    plottingInfo.plotInfo.labelsAvailable = true;
-                }
-                // Legends
-                if (inputTypes[ImPlot::Miscellaneous_e::LEGENDS].compare(str) == ImPlot::Dimension_e::ZERO)
-                {
-                    mString_t internalInput                = matlabStructArray[0][internalStr];
-                    plottingInfo.legends                   = dataFormat<mString_t, mVecString_t>(internalInput);
-                    plottingInfo.plotInfo.legendsAvailable = true;
-                }
-
-                // Limits
-                if (inputTypes[ImPlot::Miscellaneous_e::LIMITS].compare(str) == ImPlot::Dimension_e::ZERO)
-                {
-                    matlab::data::TypedArray<T> internalInput = matlabStructArray[0][internalStr];
-                    plottingInfo.limits = dataFormat<matlab::data::TypedArray<T>, std::vector<T>>(internalInput);
-                    plottingInfo.plotInfo.limitsAvailable = true;
-                }
-
-                // Uncertainty Lower-Bound
-                if (inputTypes[ImPlot::Miscellaneous_e::UNCERN_LBOUND].compare(str) == ImPlot::Dimension_e::ZERO)
-                {
-                    matlab::data::TypedArray<T> internalInput = matlabStructArray[0][internalStr];
-
-                    inputDataExtractions<matlab::data::TypedArray<T>, std::vector<std::vector<T>>, std::vector<T>>(
-                        internalInput, plottingInfo.uncertaintyLowerBound);
-                    plottingInfo.plotInfo.uncertaintyLowerBoundAvailable = true;
-                }
-
-                // Uncertainty Upper-Bound
-                if (inputTypes[ImPlot::Miscellaneous_e::UNCERN_UBOUND].compare(str) == ImPlot::Dimension_e::ZERO)
-                {
-                    matlab::data::TypedArray<T> internalInput = matlabStructArray[0][internalStr];
-                    inputDataExtractions<matlab::data::TypedArray<T>, std::vector<std::vector<T>>, std::vector<T>>(
-                        internalInput, plottingInfo.uncertaintyUpperBound);
-                    plottingInfo.plotInfo.uncertaintyUpperBoundAvailable = true;
-                }
-            }
+            samples.data2                        = getSeriesView(structField);
+            plottingInfo.plotInfo.data2Available = true;
+            break;
         }
 
-        // Only 1D data is available so available data is considered y data and populate unique x data
-        if (miscellaneousIndexStart == ImPlot::Dimension_e::ONE)
+        case ImPlot::Miscellaneous_e::PLOT_TYPES:
         {
-            plottingInfo.data2 = plottingInfo.data1;
-            plottingInfo.data1 = {};
-            for (const auto data : plottingInfo.data2)
-            {
-                std::vector<T>    vec(data.size());
-                UniqueNumber_t<T> GenerateData_t;
-                std::generate(vec.begin(), vec.end(), GenerateData_t);
-                plottingInfo.data1.push_back(vec);
-            }
+            mString_t internalInput                  = structField;
+            plottingInfo.plotTypes                   = dataFormat<mString_t, mVecString_t>(internalInput);
+            plottingInfo.plotInfo.plotTypesAvailable = true;
+            break;
+        }
+
+        case ImPlot::Miscellaneous_e::MARKER_SHAPES:
+        {
+            mString_t internalInput   = structField;
+            plottingInfo.markerShapes = getMarkerFormat<mString_t, std::vector<ImPlotMarker_>>(internalInput);
+            plottingInfo.plotInfo.markerShapesAvailable = true;
+            break;
+        }
+
+        case ImPlot::Miscellaneous_e::COLORS:
+        {
+            mString_t internalInput               = structField;
+            plottingInfo.colors                   = getColorFormat<mString_t, std::vector<ImVec4>>(internalInput);
+            plottingInfo.plotInfo.colorsAvailable = true;
+            break;
+        }
+
+        case ImPlot::Miscellaneous_e::LINE_WIDTHS:
+        {
+            matlab::data::TypedArray<T> internalInput = structField;
+            plottingInfo.lineWidth = dataFormat<matlab::data::TypedArray<T>, std::vector<T>>(internalInput);
+            plottingInfo.plotInfo.lineWidthAvailable = true;
+            break;
+        }
+
+        case ImPlot::Miscellaneous_e::MARKER_SIZES:
+        {
+            matlab::data::TypedArray<T> internalInput = structField;
+            plottingInfo.markerSize = dataFormat<matlab::data::TypedArray<T>, std::vector<T>>(internalInput);
+            plottingInfo.plotInfo.markerSizeAvailable = true;
+            break;
+        }
+
+        case ImPlot::Miscellaneous_e::TITLE:
+        {
+            mString_t internalInput              = structField;
+            plottingInfo.title                   = dataFormat<mString_t, mVecString_t>(internalInput);
+            plottingInfo.plotInfo.titleAvailable = true;
+            break;
+        }
+
+        case ImPlot::Miscellaneous_e::LABELS:
+        {
+            mString_t internalInput               = structField;
+            plottingInfo.labels                   = dataFormat<mString_t, mVecString_t>(internalInput);
+            plottingInfo.plotInfo.labelsAvailable = true;
+            break;
+        }
+
+        case ImPlot::Miscellaneous_e::LEGENDS:
+        {
+            mString_t internalInput                = structField;
+            plottingInfo.legends                   = dataFormat<mString_t, mVecString_t>(internalInput);
+            plottingInfo.plotInfo.legendsAvailable = true;
+            break;
+        }
+
+        case ImPlot::Miscellaneous_e::LIMITS:
+        {
+            matlab::data::TypedArray<T> internalInput = structField;
+            plottingInfo.limits = dataFormat<matlab::data::TypedArray<T>, std::vector<T>>(internalInput);
+            plottingInfo.plotInfo.limitsAvailable = true;
+            break;
+        }
+
+        case ImPlot::Miscellaneous_e::UNCERN_LBOUND:
+        {
+            samples.uncertaintyLowerBound                        = getMatrixView<T>(structField);
+            plottingInfo.plotInfo.uncertaintyLowerBoundAvailable = true;
+            break;
+        }
+
+        case ImPlot::Miscellaneous_e::UNCERN_UBOUND:
+        {
+            samples.uncertaintyUpperBound                        = getMatrixView<T>(structField);
+            plottingInfo.plotInfo.uncertaintyUpperBoundAvailable = true;
+            break;
+        }
+
+        case ImPlot::Miscellaneous_e::DECIMATION:
+        {
+            mString_t internalInput                   = structField;
+            plottingInfo.decimation                   = dataFormat<mString_t, mVecString_t>(internalInput);
+            plottingInfo.plotInfo.decimationAvailable = true;
+            break;
+        }
+
+        // Capacity of the ring buffers fed by "append"
+        case ImPlot::Miscellaneous_e::CAPACITY:
+        {
+            matlab::data::TypedArray<T> internalInput = structField;
+            plottingInfo.capacity = dataFormat<matlab::data::TypedArray<T>, std::vector<T>>(internalInput);
+            plottingInfo.plotInfo.capacityAvailable = true;
+            break;
+        }
+
+        // SampleRate and StartTime of implicit x
+        case ImPlot::Miscellaneous_e::SAMPLE_RATE:
+        {
+            matlab::data::TypedArray<T> internalInput = structField;
+            plottingInfo.sampleRate = dataFormat<matlab::data::TypedArray<T>, std::vector<T>>(internalInput);
+            plottingInfo.plotInfo.sampleRateAvailable = true;
+            break;
+        }
+        case ImPlot::Miscellaneous_e::START_TIME:
+        {
+            matlab::data::TypedArray<T> internalInput = structField;
+            plottingInfo.startTime = dataFormat<matlab::data::TypedArray<T>, std::vector<T>>(internalInput);
+            plottingInfo.plotInfo.startTimeAvailable = true;
+            break;
+        }
         }
     }
 
     return plottingInfo;
 }
 
-MexFunction::mImVec4_t MexFunction::getAvailableColorTypes() const
+// Copy the samples viewed by formatStructureElement into data. Plain memory only, so safe on the ingest workers.
+void MexFunction::copySamples(const ImPlot::SampleViews_t& samples, ImPlot::PlotData_t& data)
 {
-    return MatlabImGuiPlot::getAvailableColorTypes();
+    samples.copyTo(data);
+    mIngestBytes += samples.bytes();
 }
 
-MexFunction::mVecString_t MexFunction::getAvailableInputVariableNames() const
+// Field kinds of a struct shape, resolved once per distinct list of field names.
+const MexFunction::mFieldLayout_t& MexFunction::getFieldLayout(const mVecString_t& fieldNames)
 {
-    return MatlabImGuiPlot::getAvailableInputVariableNames();
-}
+    auto layout = mFieldLayouts.find(fieldNames);
+    if (layout != mFieldLayouts.end())
+    {
+        return layout->second;
+    }
 
-MexFunction::mMarkerType_t MexFunction::getAvailableMarkerInfo() const
-{
-    return MatlabImGuiPlot::getAvailableMarkerInfo();
+    // scripts use a handful of shapes; anything else is not worth keeping
+    if (mFieldLayouts.size() >= MAX_FIELD_LAYOUTS)
+    {
+        mFieldLayouts.clear();
+    }
+
+    mFieldLayout_t kinds(fieldNames.size());
+    for (size_t index = 0; index < fieldNames.size(); index++)
+    {
+        const size_t position = FIELD_INDEX.find(fieldNames[index]);
+        kinds[index]          = position == FIELD_INDEX.NONE ? UNKNOWN_FIELD : position;
+    }
+    return mFieldLayouts.emplace(fieldNames, std::move(kinds)).first->second;
 }
 
 template <class T, class U>
 U MexFunction::getColorFormat(T& data)
 {
-    T    internalInput    = data;
-    auto colorInfo        = dataFormat<T, mVecString_t>(internalInput);
-    auto colorDefinitions = getAvailableColorTypes();
-    U    output           = {};
-    for (auto& color : colorInfo)
+    T    internalInput = data;
+    auto colorInfo     = dataFormat<T, mVecString_t>(internalInput);
+    U    output        = {};
+    output.reserve(colorInfo.size());
+    for (const auto& color : colorInfo)
     {
-        for (auto& def : colorDefinitions)
+        if (const auto value = ImPlot::findColor(color))
         {
-            if ((color.compare(def.first) == ImPlot::Dimension_e::ZERO))
-            {
-                output.push_back(def.second);
-            }
+            output.push_back(*value);
         }
     }
     return output;
@@ -356,25 +781,49 @@ U MexFunction::getColorFormat(T& data)
 template <class T, class U>
 U MexFunction::getMarkerFormat(T& data)
 {
-    T    internalInput     = data;
-    auto markerShapes      = dataFormat<T, mVecString_t>(internalInput);
-    auto markerDefinitions = getAvailableMarkerInfo();
-    U    output            = {};
-    for (auto& shape : markerShapes)
+    T    internalInput = data;
+    auto markerShapes  = dataFormat<T, mVecString_t>(internalInput);
+    U    output        = {};
+    output.reserve(markerShapes.size());
+    for (const auto& shape : markerShapes)
     {
-        for (auto& def : markerDefinitions)
+        if (const auto marker = ImPlot::findMarker(shape))
         {
-            if ((shape.compare(def.first.at(ImPlot::Dimension_e::ZERO)) == ImPlot::Dimension_e::ZERO) ||
-                (shape.compare(def.first.at(ImPlot::Dimension_e::ONE)) == ImPlot::Dimension_e::ZERO))
-            {
-                output.push_back(def.second);
-            }
+            output.push_back(*marker);
         }
     }
 
     return output;
 }
 
+// Handles and subplot indices arrive as doubles; anything but a whole number from 1 up is an error, never cast.
+std::vector<uint64_t> MexFunction::getHandles(const matlab::data::Array& data)
+{
+    matlab::data::TypedArray<double> internalInput = data;
+    auto values = dataFormat<matlab::data::TypedArray<double>, std::vector<double>>(internalInput);
+    for (double value : values)
+    {
+        // 2^64 itself is not representable, so the bound is exclusive
+        if (!std::isfinite(value) || value < 1.0 || value != std::floor(value) || value >= 18446744073709551616.0)
+        {
+            displayError("Handles and subplot indices must be positive whole numbers.");
+            return {};
+        }
+    }
+    return std::vector<uint64_t>(values.begin(), values.end());
+}
+
+// A command is a call whose first argument is the command string, e.g. imGuiPlotMex("stats").
+bool MexFunction::isCommand(mArgument_t& inputs, const std::string& command)
+{
+    if (inputs.size() < ImPlot::Dimension_e::ONE || inputs[0].getType() != matlab::data::ArrayType::MATLAB_STRING)
+    {
+        return false;
+    }
+    mString_t internalInput = inputs[0];
+    return dataFormat<mString_t, mVecString_t>(internalInput)[0].compare(command) == ImPlot::Dimension_e::ZERO;
+}
+
 // Helper function to information about an invalid field in the structure.
 void MexFunction::invalidFieldInformation(std::string fieldName, size_t index)
 {
@@ -384,112 +833,418 @@ void MexFunction::invalidFieldInformation(std::string fieldName, size_t index)
     displayOnMATLAB(stream);
 }
 
-template <class T, class U, class W>
-void MexFunction::inputDataExtractions(T& data, U& formattedData)
+// Element_t is the MATLAB class read, stored as Stored_t; both have the same size. MATLAB matrices are
+// column-major, so the whole array maps onto the columnar buffer as is. Read-only elements keep MATLAB from
+// unsharing the array, and point into the buffer the argument holds for the rest of the call.
+template <class Element_t, class Stored_t>
+ImPlot::MatrixView_t MexFunction::getMatrixView(const matlab::data::Array& data)
 {
-    auto   internalInput = dataFormat<T, W>(data);
-    size_t numElements   = internalInput.size() / mColumnDimension;
-    size_t numEleCounter = ImPlot::Dimension_e::ONE;
-    W      internalVec   = {};
+    const matlab::data::TypedArray<Element_t> internalInput = data;
+    const size_t                              total         = internalInput.getNumberOfElements();
+    if (total == 0)
+    {
+        return ImPlot::MatrixView_t::of<Element_t, Stored_t>(NULL, 0, 0);
+    }
+
+    const size_t     columns = internalInput.getDimensions().at(ImPlot::Dimension_e::ONE);
+    auto             range   = matlab::data::getReadOnlyElements<Element_t>(internalInput);
+    const Element_t* first   = &*range.begin();
+    return ImPlot::MatrixView_t::of<Element_t, Stored_t>(first, total / columns, columns);
+}
 
-    for (auto& in : internalInput)
+// data1/data2 of any real numeric class, kept in that class. Throws std::invalid_argument for anything else.
+ImPlot::MatrixView_t MexFunction::getSeriesView(const matlab::data::Array& data)
+{
+    switch (data.getType())
+    {
+    case matlab::data::ArrayType::DOUBLE:
+        return getMatrixView<double>(data);
+    case matlab::data::ArrayType::SINGLE:
+        return getMatrixView<float>(data);
+    case matlab::data::ArrayType::INT8:
+        return getMatrixView<int8_t>(data);
+    case matlab::data::ArrayType::UINT8:
+        return getMatrixView<uint8_t>(data);
+    case matlab::data::ArrayType::INT16:
+        return getMatrixView<int16_t>(data);
+    case matlab::data::ArrayType::UINT16:
+        return getMatrixView<uint16_t>(data);
+    case matlab::data::ArrayType::INT32:
+        return getMatrixView<int32_t>(data);
+    case matlab::data::ArrayType::UINT32:
+        return getMatrixView<uint32_t>(data);
+    case matlab::data::ArrayType::INT64:
+        return getMatrixView<int64_t, ImS64>(data);
+    case matlab::data::ArrayType::UINT64:
+        return getMatrixView<uint64_t, ImU64>(data);
+    default:
+        throw std::invalid_argument("data1 and data2 must be real numeric arrays.");
+    }
+}
+
+// Replace the fields present in update; everything else, including cached bounds, is kept.
+ImPlot::PlotData_t MexFunction::mergeStructures(const ImPlot::PlotData_t& current, ImPlot::PlotData_t update)
+{
+    ImPlot::PlotData_t merged   = current; // sample buffers are shared, not copied
+    const auto&        plotInfo = update.plotInfo;
+
+    if (plotInfo.implicitX)
+    {
+        // data1 on its own is y for a subplot created from data1 only, and x otherwise
+        if (current.plotInfo.implicitX)
+        {
+            merged.data2 = std::move(update.data2);
+        }
+        else
+        {
+            merged.data1 = update.data2.toDouble();
+            merged.data1.broadcast(merged.data2.size());
+            merged.data1.shareIdenticalColumns();
+        }
+    }
+    else
     {
-        internalVec.push_back(in);
-        if (numEleCounter == numElements)
+        if (plotInfo.data1Available)
         {
-            formattedData.push_back(internalVec);
-            internalVec   = {};
-            numEleCounter = ImPlot::Dimension_e::ZERO;
+            merged.data1                    = std::move(update.data1);
+            merged.plotInfo.implicitX      = false;
+            merged.plotInfo.data1Available = true;
+            merged.plotInfo.onlyStructures = true;
         }
-        numEleCounter++;
+        if (plotInfo.data2Available)
+        {
+            merged.data2                   = std::move(update.data2);
+            merged.plotInfo.data2Available = true;
+        }
+    }
+
+    if (plotInfo.plotTypesAvailable)
+    {
+        merged.plotTypes                   = std::move(update.plotTypes);
+        merged.plotInfo.plotTypesAvailable = true;
+    }
+    if (plotInfo.markerShapesAvailable)
+    {
+        merged.markerShapes                   = std::move(update.markerShapes);
+        merged.plotInfo.markerShapesAvailable = true;
+    }
+    if (plotInfo.colorsAvailable)
+    {
+        merged.colors                   = std::move(update.colors);
+        merged.plotInfo.colorsAvailable = true;
     }
+    if (plotInfo.lineWidthAvailable)
+    {
+        merged.lineWidth                   = std::move(update.lineWidth);
+        merged.plotInfo.lineWidthAvailable = true;
+    }
+    if (plotInfo.markerSizeAvailable)
+    {
+        merged.markerSize                   = std::move(update.markerSize);
+        merged.plotInfo.markerSizeAvailable = true;
+    }
+    if (plotInfo.titleAvailable)
+    {
+        merged.title                   = std::move(update.title);
+        merged.plotInfo.titleAvailable = true;
+    }
+    if (plotInfo.labelsAvailable)
+    {
+        merged.labels                   = std::move(update.labels);
+        merged.plotInfo.labelsAvailable = true;
+    }
+    if (plotInfo.legendsAvailable)
+    {
+        merged.legends                   = std::move(update.legends);
+        merged.plotInfo.legendsAvailable = true;
+    }
+    if (plotInfo.limitsAvailable)
+    {
+        merged.limits                   = std::move(update.limits);
+        merged.plotInfo.limitsAvailable = true;
+    }
+    if (plotInfo.uncertaintyLowerBoundAvailable)
+    {
+        merged.uncertaintyLowerBound                   = std::move(update.uncertaintyLowerBound);
+        merged.plotInfo.uncertaintyLowerBoundAvailable = true;
+    }
+    if (plotInfo.uncertaintyUpperBoundAvailable)
+    {
+        merged.uncertaintyUpperBound                   = std::move(update.uncertaintyUpperBound);
+        merged.plotInfo.uncertaintyUpperBoundAvailable = true;
+    }
+    if (plotInfo.decimationAvailable)
+    {
+        merged.decimation                   = std::move(update.decimation);
+        merged.plotInfo.decimationAvailable = true;
+    }
+    if (plotInfo.sampleRateAvailable)
+    {
+        merged.sampleRate                   = std::move(update.sampleRate);
+        merged.plotInfo.sampleRateAvailable = true;
+    }
+    if (plotInfo.startTimeAvailable)
+    {
+        merged.startTime                   = std::move(update.startTime);
+        merged.plotInfo.startTimeAvailable = true;
+    }
+    if (plotInfo.capacityAvailable)
+    {
+        merged.capacity                   = std::move(update.capacity);
+        merged.plotInfo.capacityAvailable = true;
+    }
+
+    return merged;
 }
 
-template <class T>
-void MexFunction::process(mArgument_t& data)
+// One pass over the arguments on this thread checks their order and lists every subplot, then reads every
+// subplot's fields, viewing the samples in place. Those are then copied and prepared in parallel on plain memory
+// only, each straight into its slot, and the figures kept in order.
+template <class T, class It>
+void MexFunction::process(It first, It last)
 {
-    // Go through all the Matlab's input
-    for (auto& d : data)
+    const auto callStart = std::chrono::steady_clock::now();
+
+    /// Struct argument and its resolved fields, shared by all of its elements
+    struct StructArgument_t
     {
+        matlab::data::StructArray array;
+        mVecString_t              fieldNames;
+        mFieldLayout_t            layout;
+    };
+
+    /// Slot of a subplot and the struct element it is parsed from
+    struct Subplot_t
+    {
+        size_t figure;
+        size_t subplot;
+        size_t argument;
+        size_t element;
+    };
+
+    std::vector<ImPlot::MatlabInput_t> figures;
+    std::vector<StructArgument_t>      arguments;
+    std::vector<Subplot_t>             subplots;
+    size_t                             assigned = 0; // subplots given so far for the last figure
+    for (auto it = first; it != last; ++it)
+    {
+        auto& d = *it;
+        switch (d.getType())
+        {
         // Plot types i.e., plots or subplots.
-        if (d.getType() == matlab::data::ArrayType::MATLAB_STRING)
+        case matlab::data::ArrayType::MATLAB_STRING:
         {
+            if (!figures.empty() && assigned != figures.back().plotData.size())
+            {
+                displayError("Input should be structures, one per subplot.");
+                return;
+            }
             mString_t internalInput = d;
-            mFigureConfiguration    = dataFormat<mString_t, mVecString_t>(internalInput)[0];
+            figures.push_back({});
+            figures.back().figureConfig = dataFormat<mString_t, mVecString_t>(internalInput)[0];
+            assigned                    = 0;
+            break;
         }
 
         // If subplots, then the dimension.
-        if (d.getType() == matlab::data::ArrayType::DOUBLE)
+        case matlab::data::ArrayType::DOUBLE:
         {
             matlab::data::TypedArray<T> internalInput = d;
-            mSubPlotDimension = dataFormat<matlab::data::TypedArray<T>, std::vector<T>>(internalInput);
+            auto dimensions = dataFormat<matlab::data::TypedArray<T>, std::vector<T>>(internalInput);
+            if (figures.empty() || !figures.back().subModuleDimensions.empty() ||
+                dimensions.size() != ImPlot::Dimension_e::TWO || !(dimensions[0] >= 1) || !(dimensions[1] >= 1))
+            {
+                displayError("Input should be a vector with subplots arrangements");
+                return;
+            }
+            figures.back().plotData.resize(static_cast<size_t>(dimensions[0] * dimensions[1]));
+            figures.back().subModuleDimensions = std::move(dimensions);
+            break;
         }
 
-        // Plot info only as structures.
-        if (d.getType() == matlab::data::ArrayType::STRUCT)
+        // Plot info only as structures, a 1xN struct array is N subplots.
+        case matlab::data::ArrayType::STRUCT:
         {
             matlab::data::StructArray matlabStructArray = d;
-            auto                      res               = formatStructures<double>(matlabStructArray);
-            mStructurePlottingInfo.push_back(res);
-            if (static_cast<size_t>(mSubPlotDimension[0] * mSubPlotDimension[1]) == mStructurePlottingInfo.size())
+            const size_t              numElements       = matlabStructArray.getNumberOfElements();
+            if (figures.empty() || figures.back().subModuleDimensions.empty() ||
+                assigned + numElements > figures.back().plotData.size())
+            {
+                displayError("Incorrect input order and should be Name, Dimension, Structures with plot information.");
+                return;
+            }
+            if (!checkStructureElements(matlabStructArray))
             {
-                mInputFromMatlab.push_back({mFigureConfiguration, mSubPlotDimension, mStructurePlottingInfo});
-                mFigureConfiguration   = {};
-                mSubPlotDimension      = {};
-                mStructurePlottingInfo = {};
+                return;
             }
+
+            auto         fields = matlabStructArray.getFieldNames();
+            mVecString_t fieldNames(fields.begin(), fields.end());
+            for (size_t element = 0; element < numElements; element++)
+            {
+                subplots.push_back({figures.size() - 1, assigned++, arguments.size(), element});
+            }
+            auto layout = getFieldLayout(fieldNames);
+            arguments.push_back({matlabStructArray, std::move(fieldNames), std::move(layout)});
+            break;
+        }
+
+        default:
+            displayError("Incorrect input order and should be Name, Dimension, Structures with plot information.");
+            return;
+        }
+    }
+    if (!figures.empty() && assigned != figures.back().plotData.size())
+    {
+        displayError("Input should be structures, one per subplot.");
+        return;
+    }
+
+    // MATLAB arrays are only touched on this thread
+    std::vector<ImPlot::SampleViews_t> samples(subplots.size());
+    for (size_t index = 0; index < subplots.size(); index++)
+    {
+        const auto& subplot  = subplots[index];
+        const auto& argument = arguments[subplot.argument];
+        try
+        {
+            figures[subplot.figure].plotData[subplot.subplot] = formatStructureElement<T>(
+                argument.array, subplot.element, argument.fieldNames, argument.layout, samples[index]);
+        }
+        catch (const std::exception& error)
+        {
+            displayError(figures[subplot.figure].figureConfig + ", subplot " + std::to_string(subplot.subplot + 1) +
+                         ": " + error.what());
+            return;
+        }
+    }
+
+    if (!mIngestWorkers)
+    {
+        mIngestWorkers = std::make_unique<ImPlot::ThreadPool_t>();
+    }
+    const auto               start = std::chrono::steady_clock::now();
+    std::vector<std::string> errors(subplots.size());
+    mElementSeconds.assign(subplots.size(), 0.0);
+    auto parse = [&](size_t index)
+    {
+        const auto  subplotStart = std::chrono::steady_clock::now();
+        const auto& subplot      = subplots[index];
+        auto&       plotData     = figures[subplot.figure].plotData[subplot.subplot];
+        try
+        {
+            copySamples(samples[index], plotData);
+            MatlabImGuiPlot::prepare(plotData);
+        }
+        catch (const std::exception& error)
+        {
+            errors[index] = error.what();
         }
+        mElementSeconds[index] = std::chrono::duration<double>(std::chrono::steady_clock::now() - subplotStart).count();
+    };
+    mIngestWorkers->parallelFor(subplots.size(), parse);
+    mBatchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // MATLAB is only called back from this thread, once every subplot is done
+    for (size_t index = 0; index < subplots.size(); index++)
+    {
+        if (!errors[index].empty())
+        {
+            const auto& subplot = subplots[index];
+            displayError(figures[subplot.figure].figureConfig + ", subplot " + std::to_string(subplot.subplot + 1) +
+                         ": " + errors[index]);
+            return;
+        }
+    }
+    for (auto& figure : figures)
+    {
+        mInputFromMatlab.push_back(std::move(figure));
+    }
+    mIngestSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - callStart).count();
+}
+
+// Re-parse only the struct given for one subplot and merge it into the figure.
+void MexFunction::updateFigure(mArgument_t& inputs)
+{
+    if (inputs.size() != 4 || inputs[1].getType() != matlab::data::ArrayType::DOUBLE ||
+        inputs[2].getType() != matlab::data::ArrayType::DOUBLE ||
+        inputs[3].getType() != matlab::data::ArrayType::STRUCT)
+    {
+        displayError("Usage: imGuiPlotMex(\"update\", handle, subplot, struct).");
+        return;
+    }
+
+    const auto handles  = getHandles(inputs[1]);
+    const auto subplots = getHandles(inputs[2]);
+    auto       figure   = handles.empty() ? mFigures.end() : mFigures.find(handles[0]);
+    if (figure == mFigures.end())
+    {
+        displayError("Unknown figure handle.");
+        return;
+    }
+    if (subplots.empty() || subplots[0] == 0 || subplots[0] > figure->second.plotData.size())
+    {
+        displayError("Subplot index out of range.");
+        return;
     }
+
+    matlab::data::StructArray matlabStructArray = inputs[3];
+    if (!checkStructureElements(matlabStructArray))
+    {
+        return;
+    }
+
+    const auto start    = std::chrono::steady_clock::now();
+    auto&      plotData = figure->second.plotData[subplots[0] - 1];
+    auto       merged   = mergeStructures(plotData, formatStructures<double>(matlabStructArray));
+    try
+    {
+        MatlabImGuiPlot::prepare(merged, &plotData);
+    }
+    catch (const std::invalid_argument& error)
+    {
+        displayError(error.what());
+        return;
+    }
+    plotData = std::move(merged);
+    mIngestSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    publishFigures();
 }
 
-void MexFunction::toLower(std::string& data)
+// Send the current figure set to the render thread. Only handles to the
+// shared sample buffers are copied, so this is cheap for any data size.
+void MexFunction::publishFigures()
 {
-    std::transform(data.begin(), data.end(), data.begin(), [](unsigned char c) { return std::tolower(c); });
+    std::vector<ImPlot::MatlabInput_t> figures;
+    figures.reserve(mFigures.size());
+    for (const auto& figure : mFigures)
+    {
+        figures.push_back(figure.second);
+    }
+    mPlot.show(std::move(figures));
 }
 
-bool MexFunction::validateArguments(mArgument_t outputs, mArgument_t inputs)
+// Give each figure a handle. The subplots were already checked and prepared by process.
+std::vector<uint64_t> MexFunction::registerFigures(std::vector<ImPlot::MatlabInput_t>& figures)
 {
-    bool   status  = true;
-    size_t minSize = 3; // Need to be Name, Dimension and Structures with plot info.
-    if (inputs.size() >= minSize)
+    std::vector<uint64_t> handles = {};
+    for (auto& figure : figures)
     {
-        for (size_t index = 0; index < inputs.size(); index++)
-        {
-            if (inputs[index].getType() == matlab::data::ArrayType::MATLAB_STRING)
-            {
-                size_t innerLoop = index + 1;
-                if (inputs[innerLoop].getType() != matlab::data::ArrayType::DOUBLE)
-                {
-                    status               = false;
-                    std::string errorMsg = "Input should be a vector with subplots arrangements";
-                    displayError(errorMsg);
-                }
-
-                if (inputs[innerLoop].getType() == matlab::data::ArrayType::DOUBLE)
-                {
-                    matlab::data::TypedArray<double> internalInput = inputs[innerLoop];
-                    mSubPlotDimension =
-                        dataFormat<matlab::data::TypedArray<double>, std::vector<double>>(internalInput);
-
-                    for (size_t innerId = 1; innerId <= mSubPlotDimension[0] * mSubPlotDimension[1]; innerId++)
-                    {
-                        if (inputs[innerLoop + innerId].getType() == matlab::data::ArrayType::STRUCT)
-                        {
-                            matlab::data::StructArray matlabStructArray = inputs[innerLoop + innerId];
-                            status                                      = checkStructureElements(matlabStructArray);
-                        }
-                        else
-                        {
-                            status               = false;
-                            std::string errorMsg = "Input should be structures.";
-                            displayError(errorMsg);
-                        }
-                    }
-                }
-            }
-        }
+        const uint64_t handle = mNextHandle++;
+        figure.windowTitle    = figure.figureConfig + "##" + std::to_string(handle);
+        figure.handle         = handle;
+        mFigures[handle]      = std::move(figure);
+        handles.push_back(handle);
     }
-    else
+    return handles;
+}
+
+bool MexFunction::validateArguments(mArgument_t& outputs, mArgument_t& inputs, size_t first, size_t numOutputs)
+{
+    bool   status  = true;
+    size_t minSize = 3; // Need to be Name, Dimension and Structures with plot info.
+    // The order of the rest is checked by process, as it walks the arguments once.
+    if (inputs.size() < first + minSize)
     {
         status = false;
         std::string errorMsg =
@@ -498,10 +1253,11 @@ bool MexFunction::validateArguments(mArgument_t outputs, mArgument_t inputs)
     }
 
     // Verify the output conditions.
-    if (outputs.size() != ImPlot::Dimension_e::ZERO)
+    if (outputs.size() > numOutputs)
     {
         status               = false;
-        std::string errorMsg = "No output arguments.";
+        std::string errorMsg =
+            numOutputs == ImPlot::Dimension_e::ZERO ? "No output arguments." : "Too many output arguments.";
         displayError(errorMsg);
     }
 